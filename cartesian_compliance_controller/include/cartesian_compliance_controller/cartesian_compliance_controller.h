@@ -45,6 +45,15 @@
 #include <cartesian_motion_controller/cartesian_motion_controller.h>
 #include <cartesian_force_controller/cartesian_force_controller.h>
 
+// ROS
+#include <std_msgs/Float64MultiArray.h>
+
+// ros_control
+#include <realtime_tools/realtime_buffer.h>
+
+// Other
+#include <boost/thread/mutex.hpp>
+
 // Dynamic reconfigure
 #include <dynamic_reconfigure/server.h>
 #include <cartesian_compliance_controller/ComplianceControllerConfig.h>
@@ -71,7 +80,14 @@ namespace cartesian_compliance_controller
  * To compensate bigger offsets, users can set a low stiffness for the axes
  * where the additional forces are applied.
  *
- * @tparam HardwareInterface The interface to support. Either PositionJointInterface or VelocityJointInterface
+ * Besides the diagonal stiffness from dynamic reconfigure, a full symmetric
+ * 6x6 stiffness, optionally with a damping of the end effector velocity, can
+ * be streamed on the \a target_stiffness topic, e.g. for variable impedance.
+ * Both are given in the compliance reference frame and rotated into the
+ * robot base frame once per control cycle.
+ *
+ * @tparam HardwareInterface The interface to support. One of those of
+ * cartesian_controller_base::CartesianControllerBase
  */
 template <class HardwareInterface>
 class CartesianComplianceController
@@ -101,8 +117,41 @@ class CartesianComplianceController
      */
     ctrl::Vector6D        computeComplianceError();
 
-    ctrl::Matrix6D        m_stiffness;
+    /**
+     * @brief Take the latest stiffness and damping for this control cycle
+     *
+     * Both get rotated into the robot base frame here, so that all solver
+     * iterations of this cycle reuse them.
+     */
+    void updateImpedance();
+
+    //! Load an optional 6x6 matrix from the parameter server
+    bool loadMatrix(ros::NodeHandle& nh, const std::string& name, ctrl::Matrix6D& matrix);
+
+    void targetStiffnessCallback(const std_msgs::Float64MultiArray& msg);
+
+    struct Impedance
+    {
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      Impedance()
+        : stiffness(ctrl::Matrix6D::Zero())
+        , damping(ctrl::Matrix6D::Zero())
+      {};
+
+      ctrl::Matrix6D stiffness; ///< In compliance reference frame
+      ctrl::Matrix6D damping;   ///< In compliance reference frame
+    };
+
+    realtime_tools::RealtimeBuffer<Impedance> m_impedance_input;
+    Impedance             m_config_impedance;       ///< Latest input of the non-RT threads
+    boost::mutex          m_config_impedance_mutex;
+    ros::Subscriber       m_target_stiffness_subscriber;
+    ctrl::Matrix6D        m_stiffness;              ///< In base frame for this cycle
+    ctrl::Matrix6D        m_damping;                ///< In base frame for this cycle
+    bool                  m_damped;
     std::string           m_compliance_ref_link;
+    int                   m_compliance_ref_link_index;
 
     // Dynamic reconfigure for stiffness
     typedef cartesian_compliance_controller::ComplianceControllerConfig
@@ -46,6 +46,8 @@
 // Other
 #include <boost/algorithm/clamp.hpp>
 #include <map>
+#include <stdexcept>
+#include <vector>
 
 namespace cartesian_compliance_controller
 {
@@ -74,10 +76,29 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
     ROS_ERROR_STREAM("Failed to load " << nh.getNamespace() + "/compliance_ref_link" << " from parameter server");
     return false;
   }
+  m_compliance_ref_link_index = Base::getLinkIndex(m_compliance_ref_link);
 
   // Make sure sensor wrenches are interpreted correctly
   ForceBase::setFtSensorReferenceFrame(m_compliance_ref_link);
 
+  // Optional full matrices. Dynamic reconfigure then adjusts the stiffness' diagonal.
+  ros::NodeHandle stiffness_nh(nh.getNamespace() + "/stiffness");
+  const char* axes[6] = {"trans_x", "trans_y", "trans_z", "rot_x", "rot_y", "rot_z"};
+  if (loadMatrix(stiffness_nh,"matrix",m_config_impedance.stiffness))
+  {
+    for (int i = 0; i < 6; ++i)
+    {
+      if (!stiffness_nh.hasParam(axes[i]))
+      {
+        stiffness_nh.setParam(axes[i],m_config_impedance.stiffness(i,i));
+      }
+    }
+  }
+  loadMatrix(stiffness_nh,"damping_matrix",m_config_impedance.damping);
+  m_stiffness.setZero();
+  m_damping.setZero();
+  m_damped = false;
+
   // Connect dynamic reconfigure and overwrite the default values with values
   // on the parameter server. This is done automatically if parameters with
   // the according names exist.
@@ -89,6 +110,9 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
         ros::NodeHandle(nh.getNamespace() + "/stiffness")));
   m_dyn_conf_server->setCallback(m_callback_type);
 
+  m_target_stiffness_subscriber = nh.subscribe(
+      "target_stiffness",3,&CartesianComplianceController<HardwareInterface>::targetStiffnessCallback,this);
+
   return true;
 }
 
@@ -116,36 +140,86 @@ update(const ros::Time& time, const ros::Duration& period)
 {
   // Control the robot motion in such a way that the resulting net force
   // vanishes. This internal control needs some simulation time steps.
-  for (int i = 0; i < Base::m_iterations; ++i)
+  MotionBase::updateTargetFrame(time);
+  ForceBase::updateWrenches(period);
+  updateImpedance();
+  Base::startIterations(period);
+  for (int i = 0; i < Base::m_settings.iterations; ++i)
   {
     // The internal 'simulation time' is deliberately independent of the outer
     // control cycle.
-    ros::Duration internal_period(0.02);
+    ros::Duration internal_period = Base::m_settings.internal_period;
 
     // Compute the net force
     ctrl::Vector6D error = computeComplianceError();
 
+    // Stop early in adaptive mode
+    if (!Base::continueIterations(error))
+    {
+      break;
+    }
+
     // Turn Cartesian error into joint motion
     Base::computeJointControlCmds(error,internal_period);
   }
+  Base::finishIterations();
 
   // Write final commands to the hardware interface
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  MotionBase::publishCurrentPose(time);
 }
 
 template <>
 void CartesianComplianceController<hardware_interface::VelocityJointInterface>::
 update(const ros::Time& time, const ros::Duration& period)
 {
+  MotionBase::updateTargetFrame(time);
+  ForceBase::updateWrenches(period);
+  updateImpedance();
+
+  Base::startIterations(period);
+
   // Simulate only one step forward.
   // The constant simulation time adds to solver stability.
-  ros::Duration internal_period(0.02);
-
+  ros::Duration internal_period = Base::m_settings.internal_period;
   ctrl::Vector6D error = computeComplianceError();
 
   Base::computeJointControlCmds(error,internal_period);
+  Base::finishIterations();
 
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  MotionBase::publishCurrentPose(time);
+}
+
+template <>
+void CartesianComplianceController<hardware_interface::EffortJointInterface>::
+update(const ros::Time& time, const ros::Duration& period)
+{
+  // Start with the robot state of this cycle
+  Base::startIterations(period);
+
+  MotionBase::updateTargetFrame(time);
+  ForceBase::updateWrenches(period);
+  updateImpedance();
+
+  // One step on the real robot state without simulation.
+  // The PD controller's output is the end effector wrench.
+  ctrl::Vector6D error = computeComplianceError();
+
+  Base::computeJointControlCmds(error,period);
+  Base::finishIterations();
+
+  Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  MotionBase::publishCurrentPose(time);
 }
 
 template <class HardwareInterface>
@@ -155,14 +229,87 @@ computeComplianceError()
   ctrl::Vector6D net_force =
 
     // Spring force in base orientation
-    Base::displayInBaseLink(m_stiffness,m_compliance_ref_link) * MotionBase::computeMotionError()
+    m_stiffness * MotionBase::computeMotionError()
 
     // Sensor and target force in base orientation
     + ForceBase::computeForceError();
 
+  // Damping of the end effector velocity
+  if (m_damped)
+  {
+    net_force.noalias() -= m_damping * Base::m_ik_solver->getEndEffectorVel();
+  }
+
   return net_force;
 }
 
+template <class HardwareInterface>
+void CartesianComplianceController<HardwareInterface>::
+updateImpedance()
+{
+  const Impedance& impedance = *m_impedance_input.readFromRT();
+  m_stiffness = Base::displayInBaseLink(impedance.stiffness,m_compliance_ref_link_index);
+  m_damped = !impedance.damping.isZero(0.0);
+  if (m_damped)
+  {
+    m_damping = Base::displayInBaseLink(impedance.damping,m_compliance_ref_link_index);
+  }
+}
+
+template <class HardwareInterface>
+bool CartesianComplianceController<HardwareInterface>::
+loadMatrix(ros::NodeHandle& nh, const std::string& name, ctrl::Matrix6D& matrix)
+{
+  std::vector<double> values;
+  if (!nh.getParam(name,values))
+  {
+    return false;
+  }
+  if (values.size() != 36)
+  {
+    const std::string error = ""
+      + nh.getNamespace() + "/" + name + " must have 36 values (row-major 6x6)";
+    ROS_ERROR_STREAM(error);
+    throw std::runtime_error(error);
+  }
+  matrix = Eigen::Map<const Eigen::Matrix<double,6,6,Eigen::RowMajor> >(values.data());
+  return true;
+}
+
+template <class HardwareInterface>
+void CartesianComplianceController<HardwareInterface>::
+targetStiffnessCallback(const std_msgs::Float64MultiArray& msg)
+{
+  if (msg.data.size() != 36 && msg.data.size() != 72)
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got target stiffness with " << msg.data.size() << " values. "
+        << "Expected 36 (stiffness) or 72 (stiffness and damping), row-major.");
+    return;
+  }
+
+  typedef Eigen::Map<const Eigen::Matrix<double,6,6,Eigen::RowMajor> > MatrixMap;
+  const ctrl::Matrix6D stiffness = MatrixMap(msg.data.data());
+  const ctrl::Matrix6D damping = msg.data.size() == 72
+    ? ctrl::Matrix6D(MatrixMap(msg.data.data() + 36))
+    : ctrl::Matrix6D::Zero();
+
+  if (!stiffness.allFinite() || !damping.allFinite() ||
+      !stiffness.isApprox(stiffness.transpose()) ||
+      !damping.isApprox(damping.transpose()))
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got target stiffness or damping that is not finite and symmetric. Ignoring.");
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(m_config_impedance_mutex);
+  m_config_impedance.stiffness = stiffness;
+  if (msg.data.size() == 72)
+  {
+    m_config_impedance.damping = damping;
+  }
+  m_impedance_input.writeFromNonRT(m_config_impedance);
+}
+
 template <class HardwareInterface>
 void CartesianComplianceController<HardwareInterface>::
 dynamicReconfigureCallback(ComplianceConfig& config, uint32_t level)
@@ -174,7 +321,11 @@ dynamicReconfigureCallback(ComplianceConfig& config, uint32_t level)
   tmp[3] = config.rot_x;
   tmp[4] = config.rot_y;
   tmp[5] = config.rot_z;
-  m_stiffness = tmp.asDiagonal();
+
+  // Keep the coupling of a full stiffness
+  boost::mutex::scoped_lock lock(m_config_impedance_mutex);
+  m_config_impedance.stiffness.diagonal() = tmp;
+  m_impedance_input.writeFromNonRT(m_config_impedance);
 }
 
 } // namespace
@@ -42,6 +42,7 @@
 
 // Project
 #include <cartesian_compliance_controller/cartesian_compliance_controller.h>
+#include <cartesian_controller_base/MultiArmController.h>
 
 namespace position_controllers
 {
@@ -50,6 +51,13 @@ namespace position_controllers
    */
   typedef cartesian_compliance_controller::CartesianComplianceController<
     hardware_interface::PositionJointInterface> CartesianComplianceController;
+
+  /**
+   * @brief Several Cartesian compliance controllers on a position interface, computed in parallel.
+   */
+  typedef cartesian_controller_base::MultiArmController<
+    hardware_interface::PositionJointInterface,
+    CartesianComplianceController> CartesianMultiArmComplianceController;
 }
 
 namespace velocity_controllers
@@ -59,7 +67,70 @@ namespace velocity_controllers
    */
   typedef cartesian_compliance_controller::CartesianComplianceController<
     hardware_interface::VelocityJointInterface> CartesianComplianceController;
+
+  /**
+   * @brief Several Cartesian compliance controllers on a velocity interface, computed in parallel.
+   */
+  typedef cartesian_controller_base::MultiArmController<
+    hardware_interface::VelocityJointInterface,
+    CartesianComplianceController> CartesianMultiArmComplianceController;
+}
+
+namespace pos_vel_controllers
+{
+  /**
+   * @brief Cartesian compliance controller that implements Forward Dynamics Compliance Control (FDCC) [Scherzinger2017] on a position and velocity interface.
+   */
+  typedef cartesian_compliance_controller::CartesianComplianceController<
+    hardware_interface::PosVelJointInterface> CartesianComplianceController;
+
+  /**
+   * @brief Several Cartesian compliance controllers on a position and velocity interface, computed in parallel.
+   */
+  typedef cartesian_controller_base::MultiArmController<
+    hardware_interface::PosVelJointInterface,
+    CartesianComplianceController> CartesianMultiArmComplianceController;
+}
+
+namespace pos_vel_acc_controllers
+{
+  /**
+   * @brief Cartesian compliance controller that implements Forward Dynamics Compliance Control (FDCC) [Scherzinger2017] on a position, velocity and acceleration interface.
+   */
+  typedef cartesian_compliance_controller::CartesianComplianceController<
+    hardware_interface::PosVelAccJointInterface> CartesianComplianceController;
+
+  /**
+   * @brief Several Cartesian compliance controllers on a position, velocity and acceleration interface, computed in parallel.
+   */
+  typedef cartesian_controller_base::MultiArmController<
+    hardware_interface::PosVelAccJointInterface,
+    CartesianComplianceController> CartesianMultiArmComplianceController;
+}
+
+namespace effort_controllers
+{
+  /**
+   * @brief Cartesian compliance controller that implements Forward Dynamics Compliance Control (FDCC) [Scherzinger2017] on an effort interface.
+   */
+  typedef cartesian_compliance_controller::CartesianComplianceController<
+    hardware_interface::EffortJointInterface> CartesianComplianceController;
+
+  /**
+   * @brief Several Cartesian compliance controllers on an effort interface, computed in parallel.
+   */
+  typedef cartesian_controller_base::MultiArmController<
+    hardware_interface::EffortJointInterface,
+    CartesianComplianceController> CartesianMultiArmComplianceController;
 }
 
 PLUGINLIB_EXPORT_CLASS(position_controllers::CartesianComplianceController, controller_interface::ControllerBase)
 PLUGINLIB_EXPORT_CLASS(velocity_controllers::CartesianComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(position_controllers::CartesianMultiArmComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(velocity_controllers::CartesianMultiArmComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_controllers::CartesianComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_acc_controllers::CartesianComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(effort_controllers::CartesianComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_controllers::CartesianMultiArmComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_acc_controllers::CartesianMultiArmComplianceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(effort_controllers::CartesianMultiArmComplianceController, controller_interface::ControllerBase)
@@ -0,0 +1,733 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    solver_benchmark.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/CycleRecorder.h>
+#include <cartesian_controller_base/ForwardDynamicsSolver.h>
+#include <cartesian_controller_base/IKSolver.h>
+
+// ros_control
+#include <hardware_interface/joint_command_interface.h>
+
+// KDL
+#include <kdl/chain.hpp>
+#include <kdl/tree.hpp>
+#include <kdl_parser/kdl_parser.hpp>
+
+// Other
+#include <benchmark/benchmark.h>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Offline benchmarks for the common solver stack of all Cartesian controllers.
+ *
+ * No ROS master is needed. The controllers themselves read their
+ * configuration from the parameter server and can't be constructed here, so
+ * these benchmarks cover what every controller iteration does at its core:
+ * one forward dynamics step followed by the kinematics update, with or
+ * without the frame lookups of the force and compliance controllers.
+ *
+ * Synthetic chains with 6, 7 and 12 joints are always benchmarked.
+ * Additionally benchmark a chain from any URDF with
+ *
+ *   solver_benchmark --urdf=<file> --base=<robot_base_link> --tip=<end_effector_link>
+ *
+ * For the example robot, run xacro on robot.urdf.xacro first.
+ *
+ * Logs of the controllers' cycle recorder can be replayed with
+ *
+ *   solver_benchmark --replay=<log> --urdf=<file> --base=<robot_base_link> --tip=<end_effector_link>
+ *
+ * This repeats the first solver step of each recorded cycle with the
+ * solver's default settings, reports where the results deviate from the
+ * recorded ones and benchmarks the replay. Replay the same log with two
+ * builds to bisect regressions.
+ *
+ * All other arguments are passed on to Google Benchmark.
+ */
+
+//-----------------------------------------------------------------------------
+// Count heap allocations in the timed loops
+//-----------------------------------------------------------------------------
+#ifdef __GLIBC__
+namespace
+{
+  bool g_count_allocations = false;
+  unsigned long g_allocations = 0;
+}
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t number, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+  if (g_count_allocations) ++g_allocations;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t number, size_t size)
+{
+  if (g_count_allocations) ++g_allocations;
+  return __libc_calloc(number,size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+  if (g_count_allocations) ++g_allocations;
+  return __libc_realloc(ptr,size);
+}
+#endif
+
+namespace
+{
+
+//! Start counting allocations
+void startCounting()
+{
+#ifdef __GLIBC__
+  g_allocations = 0;
+  g_count_allocations = true;
+#endif
+}
+
+//! Stop counting and report allocations per iteration
+void stopCounting(benchmark::State& state)
+{
+#ifdef __GLIBC__
+  g_count_allocations = false;
+  state.counters["allocs/iter"] = benchmark::Counter(
+      static_cast<double>(g_allocations) / state.iterations());
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Robot models
+//-----------------------------------------------------------------------------
+
+//! Build a serial chain with alternating joint axes and a fixed tool segment
+KDL::Chain buildSyntheticChain(int number_joints)
+{
+  KDL::Chain chain;
+  for (int i = 0; i < number_joints; ++i)
+  {
+    std::stringstream name;
+    name << "link" << i + 1;
+    chain.addSegment(
+        KDL::Segment(
+          name.str(),
+          KDL::Joint(i % 2 ? KDL::Joint::RotY : KDL::Joint::RotZ),
+          KDL::Frame(KDL::Rotation::RPY(0.0,0.0,0.1 * i),KDL::Vector(0.0,0.05,0.3))));
+  }
+  chain.addSegment(
+      KDL::Segment("tool0",KDL::Joint(KDL::Joint::None),KDL::Frame(KDL::Vector(0.0,0.0,0.1))));
+  return chain;
+}
+
+//! A chain to benchmark together with a simulated robot
+struct BenchmarkRobot
+{
+  BenchmarkRobot(const KDL::Chain& chain)
+    : chain(chain)
+    , positions(chain.getNrOfJoints(), 0.1)
+    , velocities(chain.getNrOfJoints(), 0.0)
+    , efforts(chain.getNrOfJoints(), 0.0)
+  {
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+      std::stringstream name;
+      name << "joint" << i + 1;
+      handles.push_back(
+          hardware_interface::JointStateHandle(
+            name.str(),&positions[i],&velocities[i],&efforts[i]));
+    }
+  }
+
+  //! Set up a solver in a generic start state
+  void initSolver(cartesian_controller_base::IKSolver& solver) const
+  {
+    KDL::JntArray upper(chain.getNrOfJoints());
+    KDL::JntArray lower(chain.getNrOfJoints());
+    for (unsigned int i = 0; i < chain.getNrOfJoints(); ++i)
+    {
+      upper(i) = 3.14;
+      lower(i) = -3.14;
+    }
+    solver.init(chain,upper,lower);
+    solver.setStartState(handles);
+  }
+
+  KDL::Chain chain;
+  std::vector<double> positions;
+  std::vector<double> velocities;
+  std::vector<double> efforts;
+  std::vector<hardware_interface::JointStateHandle> handles;
+};
+
+std::vector<BenchmarkRobot> g_robots;
+
+//-----------------------------------------------------------------------------
+// Benchmarks
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief One solver iteration: forward dynamics step and kinematics update
+ *
+ * This is the core of each iteration of the motion controller.
+ */
+template <class HardwareInterface>
+void solverIteration(benchmark::State& state, const BenchmarkRobot* robot)
+{
+  cartesian_controller_base::ForwardDynamicsSolver solver;
+  robot->initSolver(solver);
+  solver.setRefactorizationThreshold(state.range(0) * 1.0e-4);
+
+  ctrl::Vector6D net_force;
+  net_force << 1.0, -1.0, 0.5, 0.1, -0.1, 0.05;
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+  ros::Duration period(0.02);
+
+  startCounting();
+  for (auto _ : state)
+  {
+    solver.getJointControlCmds(period,net_force,positions,velocities);
+    solver.updateKinematics<HardwareInterface>(robot->handles);
+    benchmark::DoNotOptimize(positions.data.data());
+    net_force = -net_force;
+  }
+  stopCounting(state);
+}
+
+/**
+ * @brief One solver iteration with frame lookups
+ *
+ * The force and compliance controllers additionally look up the frames of
+ * their reference links several times per iteration.
+ */
+template <class HardwareInterface>
+void solverIterationWithLookups(benchmark::State& state, const BenchmarkRobot* robot)
+{
+  cartesian_controller_base::ForwardDynamicsSolver solver;
+  robot->initSolver(solver);
+  solver.setRefactorizationThreshold(state.range(0) * 1.0e-4);
+
+  ctrl::Vector6D net_force;
+  net_force << 1.0, -1.0, 0.5, 0.1, -0.1, 0.05;
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+  ros::Duration period(0.02);
+  const int last = robot->chain.getNrOfSegments() - 1;
+  KDL::Wrench wrench(KDL::Vector(1.0,2.0,3.0),KDL::Vector(0.1,0.2,0.3));
+
+  startCounting();
+  for (auto _ : state)
+  {
+    // Lookups as in CartesianComplianceController::computeComplianceError()
+    for (int i = 0; i < 5; ++i)
+    {
+      wrench = solver.getSegmentFrames()[last].M * wrench;
+    }
+    solver.getJointControlCmds(period,net_force,positions,velocities);
+    solver.updateKinematics<HardwareInterface>(robot->handles);
+    benchmark::DoNotOptimize(positions.data.data());
+    benchmark::DoNotOptimize(&wrench);
+    net_force = -net_force;
+  }
+  stopCounting(state);
+}
+
+/**
+ * @brief Solver iterations needed to reach a target pose
+ *
+ * Runs the solver with a PD control law on a fixed Cartesian offset until the
+ * error norm drops below 1e-4, as the motion controller does in its adaptive
+ * mode.
+ *
+ * @return The number of iterations, at most 2000
+ */
+long iterationsToTarget(
+    cartesian_controller_base::IKSolver& solver,
+    const BenchmarkRobot* robot,
+    double p_gain,
+    double d_gain,
+    KDL::JntArray& positions,
+    KDL::JntArray& velocities)
+{
+  const ros::Duration period(0.02);
+  const int max_iterations = 2000;
+
+  solver.setStartState(robot->handles);
+  solver.updateKinematics<hardware_interface::PositionJointInterface>(robot->handles);
+  const KDL::Frame target(
+      solver.getEndEffectorPose().M * KDL::Rotation::RPY(0.05,-0.05,0.1),
+      solver.getEndEffectorPose().p + KDL::Vector(0.05,0.02,-0.03));
+
+  ctrl::Vector6D error;
+  ctrl::Vector6D last_error;
+  long iterations = 0;
+  for (int i = 0; i < max_iterations; ++i)
+  {
+    const KDL::Twist diff = KDL::diff(solver.getEndEffectorPose(),target);
+    for (int j = 0; j < 6; ++j)
+    {
+      error(j) = diff(j);
+    }
+    if (error.norm() < 1.0e-4)
+    {
+      break;
+    }
+    if (i == 0)
+    {
+      last_error = error;
+    }
+    const ctrl::Vector6D net_force =
+      p_gain * error + d_gain * (error - last_error) / period.toSec();
+    last_error = error;
+
+    solver.getJointControlCmds(period,net_force,positions,velocities);
+    solver.updateKinematics<hardware_interface::PositionJointInterface>(robot->handles);
+    ++iterations;
+  }
+  return iterations;
+}
+
+/**
+ * @brief Forward dynamics iterations needed to reach a target pose
+ *
+ * Compares the integrators and the reuse of the Jacobian and factorization
+ * by the number of iterations.
+ */
+void solverConvergence(benchmark::State& state, const BenchmarkRobot* robot)
+{
+  cartesian_controller_base::ForwardDynamicsSolver solver;
+  robot->initSolver(solver);
+  solver.setIntegrator(
+      static_cast<cartesian_controller_base::ForwardDynamicsSolver::Integrator>(state.range(0)));
+  solver.setJacobianThreshold(state.range(1) * 1.0e-4);
+  solver.setRefactorizationThreshold(state.range(1) * 1.0e-4);
+  solver.setNullSpaceDamping(0.5);
+
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+
+  long iterations = 0;
+  for (auto _ : state)
+  {
+    iterations += iterationsToTarget(solver,robot,10.0,3.0,positions,velocities);
+    benchmark::DoNotOptimize(positions.data.data());
+  }
+  state.counters["solver_iters"] = benchmark::Counter(
+      static_cast<double>(iterations) / state.iterations());
+}
+
+/**
+ * @brief Solver start on activation of a controller
+ *
+ * A cold start copies the joint state and recomputes all kinematics,
+ * including the Jacobian, the inertia and its factorization. A warm start
+ * swaps in the state of a hot standby solver and only updates the segment
+ * frames. The starts alternate between two joint states, as activations
+ * rarely happen where the last one stopped.
+ */
+void solverStart(benchmark::State& state, const BenchmarkRobot* robot)
+{
+  BenchmarkRobot moved(robot->chain);
+  std::fill(moved.positions.begin(),moved.positions.end(),0.2);
+  const BenchmarkRobot* robots[] = {robot, &moved};
+
+  cartesian_controller_base::ForwardDynamicsSolver solver;
+  cartesian_controller_base::ForwardDynamicsSolver standby;
+  robot->initSolver(solver);
+  robot->initSolver(standby);
+  solver.updateKinematics<hardware_interface::PositionJointInterface>(robot->handles);
+  standby.updateKinematics<hardware_interface::PositionJointInterface>(robot->handles);
+  const bool warm = state.range(0) != 0;
+
+  int start = 0;
+  startCounting();
+  for (auto _ : state)
+  {
+    const std::vector<hardware_interface::JointStateHandle>& handles = robots[++start % 2]->handles;
+    if (warm)
+    {
+      // The last state serves as the next standby
+      solver.swapState(standby);
+      solver.resumeState(handles);
+    }
+    else
+    {
+      solver.setStartState(handles);
+      solver.updateKinematics<hardware_interface::PositionJointInterface>(handles);
+    }
+    benchmark::DoNotOptimize(solver.getEndEffectorPose());
+  }
+  stopCounting(state);
+}
+
+/**
+ * @brief One iteration of the least squares solvers
+ *
+ * Same as \ref solverIteration for the given solver type.
+ */
+template <class HardwareInterface>
+void leastSquaresIteration(benchmark::State& state, const BenchmarkRobot* robot, std::string type)
+{
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+      cartesian_controller_base::IKSolver::create(type));
+  robot->initSolver(*solver);
+
+  ctrl::Vector6D net_force;
+  net_force << 1.0, -1.0, 0.5, 0.1, -0.1, 0.05;
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+  ros::Duration period(0.02);
+
+  startCounting();
+  for (auto _ : state)
+  {
+    solver->getJointControlCmds(period,net_force,positions,velocities);
+    solver->updateKinematics<HardwareInterface>(robot->handles);
+    benchmark::DoNotOptimize(positions.data.data());
+    net_force = -net_force;
+  }
+  stopCounting(state);
+}
+
+/**
+ * @brief Least squares iterations needed to reach a target pose
+ *
+ * The PD output is a Cartesian velocity for these solvers. A P gain of 25
+ * closes half of the error in each iteration of 0.02 s.
+ */
+void leastSquaresConvergence(benchmark::State& state, const BenchmarkRobot* robot, std::string type)
+{
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+      cartesian_controller_base::IKSolver::create(type));
+  robot->initSolver(*solver);
+
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+
+  long iterations = 0;
+  for (auto _ : state)
+  {
+    iterations += iterationsToTarget(*solver,robot,25.0,0.0,positions,velocities);
+    benchmark::DoNotOptimize(positions.data.data());
+  }
+  state.counters["solver_iters"] = benchmark::Counter(
+      static_cast<double>(iterations) / state.iterations());
+}
+
+//! Register all benchmarks for the given robot
+void registerBenchmarks(const std::string& name, const BenchmarkRobot* robot)
+{
+  // The argument is the refactorization threshold in 1e-4 rad
+  benchmark::RegisterBenchmark(
+      ("SolverIteration/Position/" + name).c_str(),
+      solverIteration<hardware_interface::PositionJointInterface>, robot)->Arg(0)->Arg(10);
+  benchmark::RegisterBenchmark(
+      ("SolverIteration/Velocity/" + name).c_str(),
+      solverIteration<hardware_interface::VelocityJointInterface>, robot)->Arg(0);
+  benchmark::RegisterBenchmark(
+      ("SolverIterationWithLookups/Position/" + name).c_str(),
+      solverIterationWithLookups<hardware_interface::PositionJointInterface>, robot)->Arg(0)->Arg(10);
+  benchmark::RegisterBenchmark(
+      ("SolverIterationWithLookups/Velocity/" + name).c_str(),
+      solverIterationWithLookups<hardware_interface::VelocityJointInterface>, robot)->Arg(0);
+
+  // The arguments are the integrator and the thresholds for reusing the
+  // Jacobian and the factorization in 1e-4 rad
+  benchmark::RegisterBenchmark(
+      ("SolverConvergence/" + name).c_str(),
+      solverConvergence, robot)->Args({0, 0})->Args({1, 0})->Args({2, 0})->Args({1, 10});
+
+  // The argument selects the warm start from hot standby
+  benchmark::RegisterBenchmark(
+      ("SolverStart/" + name).c_str(),
+      solverStart, robot)->Arg(0)->Arg(1);
+
+  // Alternative solvers
+  const std::string types[] = {"damped_least_squares", "qp"};
+  for (int i = 0; i < 2; ++i)
+  {
+    benchmark::RegisterBenchmark(
+        ("LeastSquaresIteration/Position/" + types[i] + "/" + name).c_str(),
+        leastSquaresIteration<hardware_interface::PositionJointInterface>, robot, types[i]);
+    benchmark::RegisterBenchmark(
+        ("LeastSquaresConvergence/" + types[i] + "/" + name).c_str(),
+        leastSquaresConvergence, robot, types[i]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Replay of recorded cycles
+//-----------------------------------------------------------------------------
+
+//! A log of the cycle recorder
+struct ReplayLog
+{
+  cartesian_controller_base::CycleRecorder::FileHeader header;
+  std::vector<double> records;
+
+  //! Get a field of the given record
+  Eigen::Map<const ctrl::VectorND> field(
+      size_t record,
+      cartesian_controller_base::CycleRecorder::Field field) const
+  {
+    typedef cartesian_controller_base::CycleRecorder Recorder;
+    return Eigen::Map<const ctrl::VectorND>(
+        &records[record * header.record_size + Recorder::offset(field,header.number_joints)],
+        Recorder::size(field,header.number_joints));
+  }
+};
+
+ReplayLog g_replay_log;
+
+/**
+ * @brief Repeat the first solver step of the given recorded cycle
+ *
+ * Recordings of joints that take torques repeat the mapping of the net
+ * force to joint torques instead. Those use \a positions for the torques.
+ *
+ * @return The largest deviation of joint positions and velocities, or of
+ * joint torques, from the recorded results
+ */
+double replayCycle(
+    cartesian_controller_base::IKSolver& solver,
+    BenchmarkRobot& robot,
+    const ReplayLog& log,
+    size_t record,
+    KDL::JntArray& positions,
+    KDL::JntArray& velocities)
+{
+  typedef cartesian_controller_base::CycleRecorder Recorder;
+
+  // Start where the solver started in this cycle
+  Eigen::Map<ctrl::VectorND>(&robot.positions[0],robot.positions.size()) =
+    log.field(record,Recorder::SOLVER_POSITIONS);
+  Eigen::Map<ctrl::VectorND>(&robot.velocities[0],robot.velocities.size()) =
+    log.field(record,Recorder::SOLVER_VELOCITIES);
+  solver.setStartState(robot.handles);
+  solver.updateKinematics<hardware_interface::PositionJointInterface>(robot.handles);
+
+  const ctrl::Vector6D net_force = log.field(record,Recorder::NET_FORCE);
+  if (log.header.joint_efforts)
+  {
+    positions.data.noalias() = solver.getJacobian().data.transpose() * net_force;
+    return (positions.data - log.field(record,Recorder::STEP_EFFORTS)).lpNorm<Eigen::Infinity>();
+  }
+  solver.getJointControlCmds(
+      ros::Duration(log.field(record,Recorder::INTERNAL_PERIOD)(0)),
+      net_force,positions,velocities);
+
+  return std::max(
+      (positions.data - log.field(record,Recorder::STEP_POSITIONS)).lpNorm<Eigen::Infinity>(),
+      (velocities.data - log.field(record,Recorder::STEP_VELOCITIES)).lpNorm<Eigen::Infinity>());
+}
+
+/**
+ * @brief Replay all recorded cycles
+ *
+ * Reports the time per replayed cycle and the largest deviation from the
+ * recorded results.
+ */
+void replay(benchmark::State& state, BenchmarkRobot* robot)
+{
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+      cartesian_controller_base::IKSolver::create(g_replay_log.header.solver_type));
+  robot->initSolver(*solver);
+
+  KDL::JntArray positions(robot->chain.getNrOfJoints());
+  KDL::JntArray velocities(robot->chain.getNrOfJoints());
+  const size_t cycles = g_replay_log.header.number_records;
+
+  double deviation = 0.0;
+  startCounting();
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < cycles; ++i)
+    {
+      deviation = std::max(deviation,replayCycle(*solver,*robot,g_replay_log,i,positions,velocities));
+    }
+    benchmark::DoNotOptimize(positions.data.data());
+  }
+  stopCounting(state);
+  state.SetItemsProcessed(state.iterations() * cycles);
+  state.counters["max_deviation"] = deviation;
+}
+
+/**
+ * @brief Print the cycles whose replay deviates from the recording
+ *
+ * @return True if all cycles match within the tolerance
+ */
+bool checkReplay(BenchmarkRobot& robot, double tolerance)
+{
+  typedef cartesian_controller_base::CycleRecorder Recorder;
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+      cartesian_controller_base::IKSolver::create(g_replay_log.header.solver_type));
+  robot.initSolver(*solver);
+
+  KDL::JntArray positions(robot.chain.getNrOfJoints());
+  KDL::JntArray velocities(robot.chain.getNrOfJoints());
+  long mismatches = 0;
+  for (size_t i = 0; i < g_replay_log.header.number_records; ++i)
+  {
+    const double deviation = replayCycle(*solver,robot,g_replay_log,i,positions,velocities);
+    if (deviation > tolerance)
+    {
+      if (mismatches == 0)
+      {
+        std::cout << "First deviating cycle: " << i
+          << " (stamp " << g_replay_log.field(i,Recorder::STAMP)(0)
+          << ", deviation " << deviation << ")" << std::endl;
+      }
+      ++mismatches;
+    }
+  }
+  std::cout << mismatches << " of " << g_replay_log.header.number_records
+    << " replayed cycles deviate by more than " << tolerance << std::endl;
+  return mismatches == 0;
+}
+
+//! Get the value of an argument --key=value and remove it from the list
+bool getArgument(int& argc, char** argv, const std::string& key, std::string& value)
+{
+  const std::string prefix = "--" + key + "=";
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strncmp(argv[i],prefix.c_str(),prefix.size()) == 0)
+    {
+      value = argv[i] + prefix.size();
+      for (int j = i; j < argc - 1; ++j)
+      {
+        argv[j] = argv[j + 1];
+      }
+      --argc;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  std::string urdf, base, tip, replay_file;
+  const bool use_urdf = getArgument(argc,argv,"urdf",urdf);
+  getArgument(argc,argv,"base",base);
+  getArgument(argc,argv,"tip",tip);
+  const bool use_replay = getArgument(argc,argv,"replay",replay_file);
+
+  if (use_replay && !cartesian_controller_base::CycleRecorder::load(
+        replay_file,g_replay_log.header,g_replay_log.records))
+  {
+    std::cerr << "Failed to read recorded cycles from " << replay_file << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Keep the robots at fixed addresses for the registered benchmarks
+  g_robots.reserve(4);
+  const int joint_counts[] = {6, 7, 12};
+  for (int i = 0; i < 3; ++i)
+  {
+    g_robots.push_back(BenchmarkRobot(buildSyntheticChain(joint_counts[i])));
+  }
+
+  if (use_urdf)
+  {
+    KDL::Tree tree;
+    KDL::Chain chain;
+    if (!kdl_parser::treeFromFile(urdf,tree) || !tree.getChain(base,tip,chain))
+    {
+      std::cerr << "Failed to parse a chain from " << base << " to " << tip
+        << " in " << urdf << std::endl;
+      return EXIT_FAILURE;
+    }
+    g_robots.push_back(BenchmarkRobot(chain));
+  }
+
+  // Replay on the given robot only
+  if (use_replay)
+  {
+    BenchmarkRobot& robot = g_robots.back();
+    boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+        cartesian_controller_base::IKSolver::create(g_replay_log.header.solver_type));
+    if (robot.chain.getNrOfJoints() != g_replay_log.header.number_joints || !solver)
+    {
+      std::cerr << "The recorded cycles need a chain with " << g_replay_log.header.number_joints
+        << " joints and the " << g_replay_log.header.solver_type << " solver" << std::endl;
+      return EXIT_FAILURE;
+    }
+    benchmark::RegisterBenchmark(
+        ("Replay/" + std::string(g_replay_log.header.solver_type)).c_str(),
+        replay, &robot);
+  }
+  else
+  {
+    for (size_t i = 0; i < g_robots.size(); ++i)
+    {
+      std::stringstream name;
+      name << (i < 3 ? "synthetic_" : "urdf_") << g_robots[i].chain.getNrOfJoints() << "dof";
+      registerBenchmarks(name.str(),&g_robots[i]);
+    }
+  }
+
+  benchmark::Initialize(&argc,argv);
+  if (benchmark::ReportUnrecognizedArguments(argc,argv))
+  {
+    return EXIT_FAILURE;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+
+  if (use_replay)
+  {
+    return checkReplay(g_robots.back(),1.0e-9) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
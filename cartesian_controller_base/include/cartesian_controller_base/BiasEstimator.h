@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    BiasEstimator.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef BIAS_ESTIMATOR_H_INCLUDED
+#define BIAS_ESTIMATOR_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+// ROS
+#include <ros/ros.h>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief Estimate the bias of a force-torque sensor
+ *
+ * Taring averages the next \a taring_samples sensor samples into a new bias.
+ * Between tarings, the bias can optionally follow slow sensor drift:
+ * Given the residual that remains after removing the bias and all known
+ * forces, e.g. gravity, the bias is low-pass filtered with the
+ * \a time_constant (in seconds, default 0 = off).  Residuals above the
+ * \a force_threshold or \a torque_threshold count as contact and leave the
+ * bias unchanged.
+ *
+ * All methods are real-time safe.
+ */
+class BiasEstimator
+{
+  public:
+    BiasEstimator();
+
+    bool init(ros::NodeHandle& nh);
+
+    //! Average the next samples into a new bias
+    void startTaring();
+
+    /**
+     * @brief Add the next sensor sample
+     *
+     * @return True if this sample completed a taring
+     */
+    bool addSample(const ctrl::Vector6D& sample);
+
+    /**
+     * @brief Follow slow drift of the bias
+     *
+     * Call this once per control cycle outside of taring.
+     *
+     * @param residual The bias-free sample minus all expected forces
+     * @param period The time since the last call
+     */
+    void track(const ctrl::Vector6D& residual, const ros::Duration& period);
+
+    //! The current bias
+    const ctrl::Vector6D& bias() const {return m_bias;}
+
+    //! Whether the bias follows drift
+    bool tracking() const {return m_time_constant > 0.0;}
+
+    //! Whether a taring is in progress
+    bool taring() const {return m_taring_count > 0;}
+
+  private:
+    ctrl::Vector6D  m_bias;
+    ctrl::Vector6D  m_sum;
+    int             m_taring_samples;
+    int             m_taring_count;
+    double          m_time_constant;
+    double          m_force_threshold;
+    double          m_torque_threshold;
+};
+
+} // namespace
+
+#endif
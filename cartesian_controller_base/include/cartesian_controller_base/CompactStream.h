@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    CompactStream.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef COMPACT_STREAM_H_INCLUDED
+#define COMPACT_STREAM_H_INCLUDED
+
+// ROS
+#include <ros/node_handle.h>
+
+// KDL
+#include <kdl/frames.hpp>
+
+// Other
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief Receiver side of a stream of compact target messages
+ *
+ * The compact messages of this package replace the frame_id strings of
+ * stamped messages with an index into the controller's \a compact/frames
+ * parameter, a list of frame names. This class resolves the expected frame to
+ * its index once, so that each message only needs an integer comparison. It
+ * also detects dropped messages by their sequence numbers.
+ *
+ * Use one instance per subscriber. It's not thread-safe.
+ */
+class CompactStream
+{
+  public:
+    CompactStream();
+
+    /**
+     * @brief Resolve the index of the expected reference frame
+     *
+     * Not real-time safe. Without a \a compact/frames parameter, the expected
+     * frame gets index zero.
+     *
+     * @param nh The controller's node handle
+     * @param topic The stream's topic, for warnings
+     * @param frame The reference frame that the controller expects
+     *
+     * @return False if \a compact/frames doesn't list the frame
+     */
+    bool init(const ros::NodeHandle& nh, const std::string& topic, const std::string& frame);
+
+    /**
+     * @brief Check a received message
+     *
+     * Gaps in the sequence numbers count as dropped messages. A sequence
+     * number that goes backwards is taken as a restart of the sender.
+     *
+     * @param frame The message's frame index
+     * @param seq The message's sequence number
+     *
+     * @return True if the message is in the expected frame
+     */
+    bool accept(uint16_t frame, uint32_t seq);
+
+    //! Number of messages that never arrived
+    unsigned long dropped() const;
+
+    //! Turn position (x, y, z) and quaternion (x, y, z, w) into a frame
+    static KDL::Frame toFrame(const float* values);
+
+    //! Turn force (x, y, z) and torque (x, y, z) into a wrench
+    static KDL::Wrench toWrench(const float* values);
+
+  private:
+    std::string   m_topic;
+    std::string   m_frame;
+    int           m_frame_index;
+    bool          m_started;
+    uint32_t      m_last_seq;
+    unsigned long m_dropped;
+};
+
+} // namespace
+
+#endif
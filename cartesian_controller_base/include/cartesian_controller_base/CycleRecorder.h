@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    CycleRecorder.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef CYCLE_RECORDER_H_INCLUDED
+#define CYCLE_RECORDER_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+// ROS
+#include <ros/time.h>
+
+// ros_controls
+#include <hardware_interface/joint_state_interface.h>
+
+// KDL
+#include <kdl/frames.hpp>
+#include <kdl/jntarray.hpp>
+#include <kdl/jntarrayvel.hpp>
+
+// Other
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <boost/atomic.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief A ring buffer of the most recent control cycles
+ *
+ * Each record holds what went into and came out of one control cycle: the
+ * joint state, the target pose, the sensor wrench, the first solver step and
+ * the final joint commands, together with the cycle's timing. All memory is
+ * allocated in \ref init, and recording in the control loop only copies into
+ * it.
+ *
+ * On request, or when the commands aren't finite, the control loop freezes
+ * the buffer after its current cycle. Another thread then writes it to a file
+ * with \ref dump, which resumes recording. Use \ref load to read such a file,
+ * e.g. to replay it through the solver.
+ */
+class CycleRecorder
+{
+  public:
+    //! Fields of a record in their order. Joint quantities have one entry per joint.
+    enum Field
+    {
+      STAMP,              ///< Steady time of the cycle's start in sec
+      PERIOD,             ///< Period of the control cycle in sec
+      INTERNAL_PERIOD,    ///< Simulated period of the solver steps in sec
+      ITERATIONS,         ///< Solver iterations in this cycle
+      CYCLE_TIME,         ///< Execution time of the cycle in sec
+      JOINT_POSITIONS,    ///< Measured joint positions
+      JOINT_VELOCITIES,   ///< Measured joint velocities
+      SOLVER_POSITIONS,   ///< Solver's joint positions before the first step
+      SOLVER_VELOCITIES,  ///< Solver's joint velocities before the first step
+      TARGET_POSE,        ///< Target pose in the base link: x, y, z, qx, qy, qz, qw
+      WRENCH,             ///< Measured wrench of the force-torque sensor
+      NET_FORCE,          ///< Solver input of the first step
+      STEP_POSITIONS,     ///< Joint positions after the first step
+      STEP_VELOCITIES,    ///< Joint velocities after the first step
+      STEP_EFFORTS,       ///< Joint torques of the first step, before the effort limits
+      CMD_POSITIONS,      ///< Commanded joint positions
+      CMD_VELOCITIES,     ///< Commanded joint velocities
+      CMD_EFFORTS,        ///< Commanded joint torques
+      NUMBER_FIELDS
+    };
+
+    //! Header of the binary files. All records follow as doubles, oldest first.
+    struct FileHeader
+    {
+      char      magic[8];         ///< "CCREC02"
+      uint32_t  number_joints;
+      uint32_t  record_size;      ///< Number of doubles per record
+      uint64_t  number_records;
+      char      solver_type[32];
+      uint32_t  joint_efforts;    ///< Nonzero if the joints were commanded torques
+    };
+
+    CycleRecorder();
+
+    /**
+     * @brief Allocate the buffer
+     *
+     * Not real-time safe.
+     *
+     * @param number_joints The number of controlled joints
+     * @param capacity The number of cycles to keep. Zero disables recording.
+     * @param solver_type The solver's name, to be stored in the files
+     * @param joint_efforts Whether the joints take torques. Their position
+     * and velocity commands are then those of the robot, and the torques
+     * are the output of the solver step.
+     */
+    void init(int number_joints, int capacity, const std::string& solver_type, bool joint_efforts);
+
+    //! Whether the recorder has a buffer
+    bool enabled() const;
+
+    // Inputs of the current cycle. They persist until overwritten.
+    void setJointState(const std::vector<hardware_interface::JointStateHandle>& joint_handles);
+    void setSolverState(const KDL::JntArray& positions, const KDL::JntArray& velocities);
+    void setTarget(const KDL::Frame& target);
+    void setWrench(const ctrl::Vector6D& wrench);
+
+    /**
+     * @brief Set the input and output of the cycle's first solver step
+     *
+     * Together with \ref setSolverState, this is enough to repeat the step
+     * offline.
+     */
+    void setFirstStep(
+        const ros::Duration& internal_period,
+        const ctrl::Vector6D& net_force,
+        const KDL::JntArray& positions,
+        const KDL::JntArray& velocities,
+        const KDL::JntArray& efforts);
+
+    /**
+     * @brief Store the current cycle in the buffer
+     *
+     * Call this at the end of each control cycle. Freezes the buffer if a
+     * dump was requested or if the commands aren't finite.
+     */
+    void finishCycle(
+        double stamp,
+        const ros::Duration& period,
+        int iterations,
+        double cycle_time,
+        const KDL::JntArrayVel& commands,
+        const KDL::JntArray& efforts);
+
+    //! Ask the control loop to freeze the buffer after its current cycle
+    void requestDump();
+
+    //! Whether the buffer is frozen and waits for \ref dump
+    bool frozen() const;
+
+    /**
+     * @brief Write the frozen buffer to a file and resume recording
+     *
+     * Not real-time safe. The file is written through a memory mapping.
+     *
+     * @param filename The file to create or overwrite
+     *
+     * @return True on success
+     */
+    bool dump(const std::string& filename);
+
+    /**
+     * @brief Read a file that was written with \ref dump
+     *
+     * @param filename The file to read
+     * @param header Gets the file's header
+     * @param records Gets all records, oldest first, each with
+     * header.record_size values
+     *
+     * @return True on success
+     */
+    static bool load(const std::string& filename, FileHeader& header, std::vector<double>& records);
+
+    //! Index of the given field within a record
+    static int offset(Field field, int number_joints);
+
+    //! Number of values of the given field
+    static int size(Field field, int number_joints);
+
+  private:
+    //! Copy values into the given field of the current record
+    void set(Field field, const double* values);
+
+    std::vector<double>   m_records;    ///< Ring of records
+    std::vector<double>   m_current;    ///< Record of the current cycle
+    int                   m_number_joints;
+    int                   m_record_size;
+    int                   m_capacity;
+    unsigned long         m_count;      ///< Records written since the last dump
+    std::string           m_solver_type;
+    bool                  m_joint_efforts;
+
+    boost::atomic<bool>   m_dump_requested;
+    boost::atomic<bool>   m_frozen;
+};
+
+} // namespace
+
+#endif
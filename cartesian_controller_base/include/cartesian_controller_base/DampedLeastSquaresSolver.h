@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    DampedLeastSquaresSolver.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef DAMPED_LEAST_SQUARES_SOLVER_H_INCLUDED
+#define DAMPED_LEAST_SQUARES_SOLVER_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/IKSolver.h>
+
+namespace cartesian_controller_base{
+
+/*! \brief Closed-form velocity inverse kinematics with damped least squares
+ *
+ *  The Cartesian input is taken as the desired end effector velocity
+ *  \f$ \dot{x} \f$. The joint velocities are then computed in one shot with
+ *  \f$ \dot{q} = J^T (J J^T + \lambda^2 I)^{-1} \dot{x} \f$, where the damping
+ *  \f$ \lambda \f$ limits the joint velocities close to singularities.
+ *  The joint positions follow by integration over the given period.
+ *
+ *  Compared to the \ref ForwardDynamicsSolver, a single iteration per control
+ *  cycle is usually enough. Choose the PD gains so that their output is a
+ *  reasonable end effector velocity.
+ */
+class DampedLeastSquaresSolver : public IKSolver
+{
+  public:
+    DampedLeastSquaresSolver();
+    ~DampedLeastSquaresSolver();
+
+    using IKSolver::getJointControlCmds;
+
+    /**
+     * @brief Compute joint target commands with damped least squares
+     *
+     * @param period The duration in sec for this step
+     * @param net_force The desired end effector velocity, expressed in the root frame
+     * @param positions Buffer for the resulting joint positions
+     * @param velocities Buffer for the resulting joint velocities
+     */
+    void getJointControlCmds(
+        ros::Duration period,
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& positions,
+        KDL::JntArray& velocities);
+
+    /**
+     * @brief Set the damping of the least squares problem
+     *
+     * Larger values give smaller joint velocities close to singularities at
+     * the cost of tracking accuracy.
+     *
+     * @param damping The damping \f$ \lambda \f$. Must be positive.
+     */
+    void setDamping(double damping);
+
+  protected:
+    /**
+     * @brief Compute the joint velocities for the desired end effector velocity
+     *
+     * @param cartesian_velocity The desired end effector velocity
+     * @param dt The duration in sec of this step
+     * @param velocities The resulting joint velocities
+     */
+    virtual void computeJointVelocities(
+        const ctrl::Vector6D& cartesian_velocity,
+        double dt,
+        KDL::JntArray& velocities);
+
+    /**
+     * @brief Factorize \f$ J J^T + \lambda^2 I \f$ of the current Jacobian
+     *
+     * This also updates the condition estimate, which includes the constant
+     * damping, and adds the singularity damping if needed.
+     */
+    void factorizeJacobian();
+
+    double m_damping;
+
+  private:
+    ctrl::Matrix6D              m_jacobian_gram;
+    Eigen::LDLT<ctrl::Matrix6D> m_decomposition;
+    ctrl::Vector6D              m_cartesian_buffer;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    ForwardDynamicsKernel.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef FORWARD_DYNAMICS_KERNEL_H_INCLUDED
+#define FORWARD_DYNAMICS_KERNEL_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+// KDL
+#include <kdl/jntarray.hpp>
+#include <kdl/jacobian.hpp>
+#include <kdl/jntspaceinertiamatrix.hpp>
+
+namespace cartesian_controller_base{
+
+/*! \brief Interface to the linear algebra of the \ref ForwardDynamicsSolver
+ *
+ *  A kernel holds the Jacobian and the factorized joint space inertia matrix
+ *  of the current joint configuration and computes the joint accelerations
+ *  for a given Cartesian net force.
+ *  Use \ref create() to get an implementation that matches the number of
+ *  joints. Common joint counts are served with fixed-size Eigen types, so that
+ *  the compiler can unroll and vectorize the solve.
+ */
+class ForwardDynamicsKernelBase
+{
+  public:
+    virtual ~ForwardDynamicsKernelBase(){};
+
+    /**
+     * @brief Create a kernel for the given number of joints
+     *
+     * Chains with 6 and 7 joints get fixed-size implementations. All other
+     * chains fall back to dynamic-size types.
+     *
+     * @param number_joints The number of controllable joints of the chain
+     *
+     * @return A heap-allocated kernel. The caller takes ownership.
+     */
+    static ForwardDynamicsKernelBase* create(int number_joints);
+
+    //! Copy the joint Jacobian of the current configuration
+    virtual void setJacobian(const KDL::Jacobian& jacobian) = 0;
+
+    //! Copy and factorize the joint space inertia matrix of the current configuration
+    virtual void setJntSpaceInertia(const KDL::JntSpaceInertiaMatrix& inertia) = 0;
+
+    /**
+     * @brief Estimate the condition number of the factorized inertia
+     *
+     * @return The ratio of the largest and smallest pivots of the factorization
+     */
+    virtual double getConditionEstimate() const = 0;
+
+    /**
+     * @brief Compute joint accelerations according to \f$ \ddot{q} = H^{-1} ( J^T f) \f$
+     *
+     * @param net_force The applied net force, expressed in the root frame
+     * @param accelerations Buffer for the resulting joint accelerations
+     */
+    virtual void computeAccelerations(
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& accelerations) = 0;
+
+    /**
+     * @brief Damp the joint velocities that don't move the end effector
+     *
+     * Removes the given fraction of the velocities' component in the null
+     * space of the Jacobian. The null space projector is cached until the
+     * Jacobian changes.
+     *
+     * @param damping Fraction between 0 and 1 to remove
+     * @param velocities The joint velocities to damp
+     */
+    virtual void dampNullSpace(double damping, KDL::JntArray& velocities) = 0;
+};
+
+/*! \brief Kernel implementation for a given number of joints
+ *
+ * @tparam Joints The number of joints, or Eigen::Dynamic
+ */
+template <int Joints>
+class ForwardDynamicsKernel : public ForwardDynamicsKernelBase
+{
+  public:
+    typedef Eigen::Matrix<double,Joints,1>        JointVector;
+    typedef Eigen::Matrix<double,6,Joints>        Jacobian;
+    typedef Eigen::Matrix<double,Joints,Joints>   JntSpaceInertia;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    explicit ForwardDynamicsKernel(int number_joints);
+
+    void setJacobian(const KDL::Jacobian& jacobian);
+
+    void setJntSpaceInertia(const KDL::JntSpaceInertiaMatrix& inertia);
+
+    double getConditionEstimate() const;
+
+    void computeAccelerations(
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& accelerations);
+
+    void dampNullSpace(double damping, KDL::JntArray& velocities);
+
+  private:
+    //! Compute the null space projector of the current Jacobian and inertia
+    void computeNullSpaceProjector();
+
+    Jacobian                      m_jnt_jacobian;
+    Eigen::LDLT<JntSpaceInertia>  m_jnt_space_inertia_decomposition;
+    JointVector                   m_jnt_space_force;
+
+    // Null space
+    Eigen::LDLT<ctrl::Matrix6D>   m_jacobian_gram_decomposition;  ///< Of \f$ J J^T \f$
+    Jacobian                      m_cartesian_projection;         ///< \f$ (J J^T)^{-1} J \f$
+    JntSpaceInertia               m_null_space_projector;
+    JointVector                   m_null_space_velocities;
+    bool                          m_null_space_valid;
+};
+
+} // namespace
+
+#include "ForwardDynamicsKernel.hpp"
+
+#endif
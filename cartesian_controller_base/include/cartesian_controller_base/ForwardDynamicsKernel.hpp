@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    ForwardDynamicsKernel.hpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// this package
+#include <cartesian_controller_base/ForwardDynamicsKernel.h>
+
+namespace cartesian_controller_base{
+
+template <int Joints>
+ForwardDynamicsKernel<Joints>::ForwardDynamicsKernel(int number_joints)
+  : m_jnt_jacobian(6,number_joints)
+  , m_jnt_space_inertia_decomposition(number_joints)
+  , m_cartesian_projection(6,number_joints)
+  , m_null_space_projector(number_joints,number_joints)
+  , m_null_space_valid(false)
+{
+  // Fixed-size types only check the size here
+  m_jnt_jacobian.setZero();
+  m_jnt_space_force.resize(number_joints);
+  m_jnt_space_force.setZero();
+  m_null_space_velocities.resize(number_joints);
+  m_null_space_velocities.setZero();
+}
+
+template <int Joints>
+void ForwardDynamicsKernel<Joints>::setJacobian(const KDL::Jacobian& jacobian)
+{
+  m_jnt_jacobian = jacobian.data;
+  m_null_space_valid = false;
+}
+
+template <int Joints>
+void ForwardDynamicsKernel<Joints>::setJntSpaceInertia(const KDL::JntSpaceInertiaMatrix& inertia)
+{
+  // Reuses the memory of the preallocated decomposition
+  m_jnt_space_inertia_decomposition.compute(inertia.data);
+}
+
+template <int Joints>
+double ForwardDynamicsKernel<Joints>::getConditionEstimate() const
+{
+  // The pivots lie between the smallest and largest eigenvalues
+  return m_jnt_space_inertia_decomposition.vectorD().cwiseAbs().maxCoeff() /
+         m_jnt_space_inertia_decomposition.vectorD().cwiseAbs().minCoeff();
+}
+
+template <int Joints>
+void ForwardDynamicsKernel<Joints>::computeAccelerations(
+    const ctrl::Vector6D& net_force,
+    KDL::JntArray& accelerations)
+{
+  m_jnt_space_force.noalias() = m_jnt_jacobian.transpose() * net_force;
+  accelerations.data = m_jnt_space_inertia_decomposition.solve(m_jnt_space_force);
+}
+
+template <int Joints>
+void ForwardDynamicsKernel<Joints>::dampNullSpace(double damping, KDL::JntArray& velocities)
+{
+  if (!m_null_space_valid)
+  {
+    computeNullSpaceProjector();
+  }
+  m_null_space_velocities.noalias() = m_null_space_projector * velocities.data;
+  velocities.data -= damping * m_null_space_velocities;
+}
+
+template <int Joints>
+void ForwardDynamicsKernel<Joints>::computeNullSpaceProjector()
+{
+  // \f$ N = I - J^T (J J^T)^{-1} J \f$. The kinematic projector is
+  // better conditioned than the dynamically consistent one, since the
+  // virtual model's inertia is close to singular in the null space.
+  m_jacobian_gram_decomposition.compute(m_jnt_jacobian * m_jnt_jacobian.transpose());
+  m_cartesian_projection = m_jnt_jacobian;
+  m_jacobian_gram_decomposition.solveInPlace(m_cartesian_projection);
+
+  m_null_space_projector.setIdentity();
+  m_null_space_projector.noalias() -= m_jnt_jacobian.transpose() * m_cartesian_projection;
+  m_null_space_valid = true;
+}
+
+}
@@ -42,28 +42,12 @@
 #define FORWARD_DYNAMICS_CONTROLLER_H_INCLUDED
 
 // Project
-#include <cartesian_controller_base/Utility.h>
-
-// ros_controls
-#include <hardware_interface/joint_command_interface.h>
-
-// ros general
-#include <ros/ros.h>
-#include <trajectory_msgs/JointTrajectoryPoint.h>
+#include <cartesian_controller_base/IKSolver.h>
+#include <cartesian_controller_base/ForwardDynamicsKernel.h>
 
 // other
-#include <vector>
 #include <boost/shared_ptr.hpp>
 
-// KDL
-#include <kdl/frames.hpp>
-#include <kdl/chain.hpp>
-#include <kdl/jacobian.hpp>
-#include <kdl/chainjnttojacsolver.hpp>
-#include <kdl/chaindynparam.hpp>
-#include <kdl/chainfksolverpos_recursive.hpp>
-#include <kdl/chainfksolvervel_recursive.hpp>
-
 namespace cartesian_controller_base{
 
 /*! \brief This class computes manipulator joint motion from Cartesian force inputs.
@@ -79,14 +63,27 @@ namespace cartesian_controller_base{
  *  the applied force to the end effector.  The joint accelerations are
  *  integrated twice to obtain joint velocities and joint positions
  *  respectively.
+ *  Since \f$ H \f$ is symmetric and positive definite by construction, the
+ *  solver never inverts it explicitly but uses a cached \f$ LDL^T \f$
+ *  factorization instead.
  *  Check more details behind the solver here: https://arxiv.org/pdf/1908.06252.pdf
  */
-class ForwardDynamicsSolver
+class ForwardDynamicsSolver : public IKSolver
 {
   public:
+    //! Schemes to integrate the joint accelerations of one simulation step
+    enum Integrator
+    {
+      ZERO_MOTION,            ///< Start each step at rest
+      SEMI_IMPLICIT_EULER,    ///< Update velocities first, then positions with the new velocities
+      CONSTANT_ACCELERATION   ///< Exact integration of the step's constant acceleration
+    };
+
     ForwardDynamicsSolver();
     ~ForwardDynamicsSolver();
 
+    using IKSolver::getJointControlCmds;
+
     /**
      * @brief Compute joint target commands with approximate forward dynamics
      *
@@ -95,45 +92,30 @@ class ForwardDynamicsSolver
      *
      * @param period The duration in sec for this simulation step
      * @param net_force The applied net force, expressed in the root frame
-     *
-     * @return A point holding positions, velocities and accelerations of each joint
+     * @param positions Buffer for the resulting joint positions
+     * @param velocities Buffer for the resulting joint velocities
      */
-    trajectory_msgs::JointTrajectoryPoint getJointControlCmds(
+    void getJointControlCmds(
         ros::Duration period,
-        const ctrl::Vector6D& net_force);
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& positions,
+        KDL::JntArray& velocities);
 
     /**
-     * @brief Get the current end effector pose of the simulated robot
+     * @brief Exchange the simulation state with another solver
      *
-     * The last link in the chain from the init() function is taken as end
-     * effector. If \ref setStartState() has been called immediately before,
-     * then the returned pose represents the real robots end effector pose.
+     * In addition to the common state, this swaps the factorized inertia.
      *
-     * @return The end effector pose with respect to the robot base link. This
-     * link is the same as the one implicitly given in the init() function.
+     * @param other A ForwardDynamicsSolver initialized with the same chain
      */
-    const KDL::Frame& getEndEffectorPose() const;
+    void swapState(IKSolver& other);
 
     /**
-     * @brief Get the current end effector velocity of the simulated robot
-     *
-     * The last link in the chain from the init() function is taken as end
-     * effector.
+     * @brief Continue a handed over state from the current joint state
      *
-     * @return The end effector vel with respect to the robot base link. The
-     * order is first translation, then rotation.
+     * In addition to the common caches, this keeps the factorized inertia.
      */
-    const ctrl::Vector6D& getEndEffectorVel() const;
-
-    /**
-     * @brief Get the current joint positions of the simulated robot
-     *
-     * @return The current joint positions
-     */
-    const KDL::JntArray& getPositions() const;
-
-    //! Set initial joint configuration
-    bool setStartState(const std::vector<hardware_interface::JointHandle>& joint_handles);
+    void resumeState(const std::vector<hardware_interface::JointStateHandle>& joint_handles);
 
     /**
      * @brief Initialize the solver
@@ -149,64 +131,76 @@ class ForwardDynamicsSolver
               const KDL::JntArray& lower_pos_limits);
 
     /**
-     * @brief Update the robot kinematics of the solver
+     * @brief Set when to refactorize the joint space inertia matrix
+     *
+     * The factorization of the joint space inertia matrix is reused for
+     * subsequent simulation steps as long as no joint has moved more than the
+     * given threshold since the last factorization. The default of zero
+     * refactorizes on every change of the joint configuration.
      *
-     * This template has two specializations for two distinct controller
-     * policies, depending on the hardware interface used:
+     * Refactorizing the joint space inertia always recomputes the Jacobian.
      *
-     * 1) PositionJointInterface: The solver's internal simulation is continued
-     * on each call without taking the real robot state into account.
+     * @param threshold Maximal joint offset in rad (or m for prismatic joints)
+     */
+    void setRefactorizationThreshold(double threshold);
+
+    /**
+     * @brief Set the integration scheme for the simulation steps
      *
-     * 2) VelocityJointInterface: The internal simulation is updated with the
-     * real robot state. On each call, the solver starts with its internal
-     * simulation in sync with the real robot.
+     * The default of \ref ZERO_MOTION starts each simulation step with zero
+     * joint velocities, which damps the simulated system strongly. The other
+     * integrators carry the joint velocities over to the next step, so that
+     * the system needs fewer steps to follow large errors. This requires
+     * derivative gains in the PD controllers to damp the motion.
      *
-     * @tparam HardwareInterface
-     * @param joint_handles
+     * @param integrator The scheme to use
      */
-    template <class HardwareInterface>
-    void updateKinematics(
-        const std::vector<hardware_interface::JointHandle>& joint_handles);
+    void setIntegrator(Integrator integrator);
+
+    /**
+     * @brief Damp carried-over joint velocities in the Jacobian's null space
+     *
+     * Redundant robots can move their joints without moving the end effector.
+     * The PD controllers don't see any error from such motion, so integrators
+     * that carry joint velocities over to the next step would let it drift
+     * freely. This removes the given fraction of the null space velocities in
+     * each step. It has no effect with \ref ZERO_MOTION and on non-redundant
+     * robots.
+     *
+     * @param damping Fraction between 0 and 1
+     */
+    void setNullSpaceDamping(double damping);
+
+  protected:
+    /**
+     * @brief Compute all kinematic and dynamic quantities of the current joint state
+     *
+     * In addition to the common kinematics, this computes the joint space
+     * inertia matrix if the current factorization is outdated, and hands
+     * both over to the solver kernel.
+     */
+    void computeChainQuantities();
 
   private:
 
     //! Build a generic robot model for control
     bool buildGenericModel(const KDL::Chain& input_chain);
 
-    //! The underlying physical system
-    KDL::Chain m_chain;
-
-    //! Number of controllable joint
-    int m_number_joints;
-
-    // Internal buffers
-    KDL::JntArray m_current_positions;
-    KDL::JntArray m_current_velocities;
-    KDL::JntArray m_current_accelerations;
-    KDL::JntArray m_last_positions;
-
-    // Joint limits
-    KDL::JntArray m_upper_pos_limits;
-    KDL::JntArray m_lower_pos_limits;
-
-    // Forward kinematics
-    boost::shared_ptr<
-      KDL::ChainFkSolverPos_recursive>  m_fk_pos_solver;
-    boost::shared_ptr<
-      KDL::ChainFkSolverVel_recursive>  m_fk_vel_solver;
-    KDL::Frame                          m_end_effector_pose;
-    ctrl::Vector6D                      m_end_effector_vel;
-
     // Forward dynamics
-    boost::shared_ptr<KDL::ChainJntToJacSolver> m_jnt_jacobian_solver;
-    boost::shared_ptr<KDL::ChainDynParam>       m_jnt_space_inertia_solver;
-    KDL::Jacobian                               m_jnt_jacobian;
     KDL::JntSpaceInertiaMatrix                  m_jnt_space_inertia;
+    boost::shared_ptr<
+      ForwardDynamicsKernelBase>                m_kernel;
+    KDL::JntArray                               m_factorized_positions;
+    double                                      m_refactorization_threshold;
+    bool                                        m_factorization_valid;
+
+    // Integration
+    Integrator                                  m_integrator;
+    double                                      m_null_space_damping;
 };
 
 
 } // namespace
 
-#include "ForwardDynamicsSolver.hpp"
 
 #endif
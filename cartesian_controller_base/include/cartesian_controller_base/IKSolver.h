@@ -0,0 +1,448 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    IKSolver.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef IK_SOLVER_H_INCLUDED
+#define IK_SOLVER_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+// ros_controls
+#include <hardware_interface/joint_command_interface.h>
+
+// ros general
+#include <ros/ros.h>
+#include <trajectory_msgs/JointTrajectoryPoint.h>
+
+// other
+#include <string>
+#include <vector>
+
+// KDL
+#include <kdl/frames.hpp>
+#include <kdl/chain.hpp>
+#include <kdl/jacobian.hpp>
+#include <kdl/jntarray.hpp>
+#include <kdl/jntspaceinertiamatrix.hpp>
+
+namespace cartesian_controller_base{
+
+/*! \brief Common interface of the solvers that turn Cartesian inputs into joint motion
+ *
+ *  All Cartesian controllers compute a Cartesian input from their control
+ *  error and let a solver turn it into joint commands. This class holds what
+ *  all solvers share: the joint state of the simulated robot, its joint
+ *  limits and the cached kinematics of the current joint configuration.
+ *  Implementations differ in how \ref getJointControlCmds maps the
+ *  Cartesian input to joint motion.
+ *
+ *  Use \ref create() to get a solver by name.
+ */
+class IKSolver
+{
+  public:
+    IKSolver();
+    virtual ~IKSolver();
+
+    /**
+     * @brief Create a solver by name
+     *
+     * Not real-time safe.
+     *
+     * @param type One of \a forward_dynamics, \a damped_least_squares or \a qp
+     *
+     * @return A heap-allocated solver, or NULL if the type is unknown.
+     * The caller takes ownership.
+     */
+    static IKSolver* create(const std::string& type);
+
+    /**
+     * @brief Compute joint target commands for the given Cartesian input
+     *
+     * @param period The duration in sec for this simulation step
+     * @param net_force The Cartesian input, expressed in the root frame
+     *
+     * @return A point holding positions and velocities of each joint
+     */
+    trajectory_msgs::JointTrajectoryPoint getJointControlCmds(
+        ros::Duration period,
+        const ctrl::Vector6D& net_force);
+
+    /**
+     * @brief Compute joint target commands for the given Cartesian input
+     *
+     * Variant of the function above for use in the control loop. The results
+     * are written into the given buffers, which do not get reallocated if
+     * they already have the size of the number of controlled joints.
+     *
+     * @param period The duration in sec for this simulation step
+     * @param net_force The Cartesian input, expressed in the root frame
+     * @param positions Buffer for the resulting joint positions
+     * @param velocities Buffer for the resulting joint velocities
+     */
+    virtual void getJointControlCmds(
+        ros::Duration period,
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& positions,
+        KDL::JntArray& velocities) = 0;
+
+    /**
+     * @brief Get the current end effector pose of the simulated robot
+     *
+     * The last link in the chain from the init() function is taken as end
+     * effector. If \ref setStartState() has been called immediately before,
+     * then the returned pose represents the real robots end effector pose.
+     *
+     * @return The end effector pose with respect to the robot base link. This
+     * link is the same as the one implicitly given in the init() function.
+     */
+    const KDL::Frame& getEndEffectorPose() const;
+
+    /**
+     * @brief Get the current end effector velocity of the simulated robot
+     *
+     * The last link in the chain from the init() function is taken as end
+     * effector.
+     *
+     * @return The end effector vel with respect to the robot base link. The
+     * order is first translation, then rotation.
+     */
+    const ctrl::Vector6D& getEndEffectorVel() const;
+
+    /**
+     * @brief Get the tip frames of all segments of the simulated robot
+     *
+     * The frames are cached for the current joint positions and only get
+     * recomputed when these change.
+     *
+     * @return The frames with respect to the robot base link, in the order of
+     * the chain's segments
+     */
+    const std::vector<KDL::Frame>& getSegmentFrames();
+
+    /**
+     * @brief Get the joint Jacobian of the simulated robot
+     *
+     * Like the segment frames, the Jacobian is cached and only gets updated
+     * according to \ref setJacobianThreshold.
+     *
+     * @return The Jacobian with respect to the robot base link, with the end
+     * effector as reference point
+     */
+    const KDL::Jacobian& getJacobian();
+
+    /**
+     * @brief Get the current joint positions of the simulated robot
+     *
+     * @return The current joint positions
+     */
+    const KDL::JntArray& getPositions() const;
+
+    /**
+     * @brief Get the current joint velocities of the simulated robot
+     *
+     * @return The current joint velocities
+     */
+    const KDL::JntArray& getVelocities() const;
+
+    //! Set initial joint configuration
+    bool setStartState(const std::vector<hardware_interface::JointStateHandle>& joint_handles);
+
+    /**
+     * @brief Exchange the simulation state with another solver
+     *
+     * This swaps joint states and cached kinematics without copying or
+     * allocating. Use it to hand over a state that was prepared outside the
+     * control loop.
+     *
+     * @param other A solver of the same type, initialized with the same chain
+     */
+    virtual void swapState(IKSolver& other);
+
+    /**
+     * @brief Continue a handed over state from the current joint state
+     *
+     * Copies the joint state like \ref setStartState, but keeps all cached
+     * quantities of the handed over state, such as the Jacobian, as if they
+     * were computed for the new joint positions. Only the segment frames and
+     * the end effector motion get updated, in one pass without the Jacobian.
+     * The cached quantities are then due for an update once the joints move
+     * beyond their thresholds of the new positions.
+     *
+     * Use this after \ref swapState if the joints have moved only little
+     * since the other solver's state was prepared.
+     */
+    virtual void resumeState(const std::vector<hardware_interface::JointStateHandle>& joint_handles);
+
+    /**
+     * @brief Initialize the solver
+     *
+     * @param chain The kinematic chain of the robot
+     * @param upper_pos_limits Tuple with max positive joint angles
+     * @param lower_pos_limits Tuple with max negative joint angles
+     *
+     * @return True, if everything went well
+     */
+    virtual bool init(const KDL::Chain& chain,
+                      const KDL::JntArray& upper_pos_limits,
+                      const KDL::JntArray& lower_pos_limits);
+
+    /**
+     * @brief Update the robot kinematics of the solver
+     *
+     * This template has specializations for two distinct controller
+     * policies, depending on the hardware interface used:
+     *
+     * 1) PositionJointInterface, PosVelJointInterface and
+     * PosVelAccJointInterface: The solver's internal simulation is continued
+     * on each call without taking the real robot state into account.
+     *
+     * 2) VelocityJointInterface and EffortJointInterface: The internal
+     * simulation is updated with the real robot state. On each call, the
+     * solver starts with its internal simulation in sync with the real robot.
+     *
+     * @tparam HardwareInterface
+     * @param joint_handles
+     */
+    template <class HardwareInterface>
+    void updateKinematics(
+        const std::vector<hardware_interface::JointStateHandle>& joint_handles);
+
+    /**
+     * @brief Set when to recompute the joint Jacobian
+     *
+     * The Jacobian of the last computation is reused as long as no joint has
+     * moved more than the given threshold since then. The segment frames and
+     * the end effector pose are always up to date. The default of zero
+     * recomputes on every change of the joint configuration.
+     *
+     * @param threshold Maximal joint offset in rad (or m for prismatic joints)
+     */
+    void setJacobianThreshold(double threshold);
+
+    /**
+     * @brief Set the joint velocity and acceleration limits
+     *
+     * These limit the commands of each control cycle with \ref
+     * limitPositionCommands and \ref limitVelocityCommands. The simulated
+     * motion of the solver steps within a cycle is not limited. Use infinity
+     * for joints without the respective limit.
+     *
+     * @param max_velocities Maximal absolute joint velocities
+     * @param max_accelerations Maximal absolute joint accelerations
+     */
+    void setMotionLimits(const KDL::JntArray& max_velocities,
+                         const KDL::JntArray& max_accelerations);
+
+    /**
+     * @brief Keep the position commands of one control cycle within the limits
+     *
+     * Turns the joint motion from the last commanded positions to the given
+     * ones into velocities over the control period. These are scaled with
+     * one common factor, so that they respect the velocity limits and change
+     * by at most the acceleration limits times the period. This keeps the
+     * motion's direction in Cartesian space to first order. Only if no such
+     * factor exists, e.g. when a joint cannot decelerate in time, each joint
+     * is limited on its own. The positions stay within their limits.
+     *
+     * @param last_positions The commanded positions of the last cycle
+     * @param last_velocities The commanded velocities of the last cycle
+     * @param period The period of the control cycle
+     * @param positions The solver's positions at the end of this cycle. Limited on return.
+     * @param velocities The velocities that reach the limited positions within the period
+     *
+     * @return True if the positions were limited
+     */
+    bool limitPositionCommands(const KDL::JntArray& last_positions,
+                               const KDL::JntArray& last_velocities,
+                               const ros::Duration& period,
+                               KDL::JntArray& positions,
+                               KDL::JntArray& velocities) const;
+
+    /**
+     * @brief Keep the velocity commands of one control cycle within the limits
+     *
+     * Same as \ref limitPositionCommands for commands that are velocities.
+     *
+     * @param last_velocities The commanded velocities of the last cycle
+     * @param period The period of the control cycle
+     * @param velocities The solver's velocities of this cycle. Limited on return.
+     *
+     * @return True if the velocities were limited
+     */
+    bool limitVelocityCommands(const KDL::JntArray& last_velocities,
+                               const ros::Duration& period,
+                               KDL::JntArray& velocities) const;
+
+    /**
+     * @brief Continue the simulation from the given joint positions
+     *
+     * Use this to keep the solver at limited position commands. The joints
+     * lose their simulated velocity, as at their position limits.
+     *
+     * @param positions The new joint positions
+     */
+    void setPositions(const KDL::JntArray& positions);
+
+    /**
+     * @brief Set when and how strongly to damp the solve near singularities
+     *
+     * Each solver estimates the condition number of the system it factorizes.
+     * Above the given threshold, it adds \f$ \lambda^2 I \f$ to that system,
+     * with \f$ \lambda^2 \f$ rising smoothly from zero at the threshold to
+     * the given damping for ill-conditioned systems. Well-conditioned
+     * configurations are solved exactly.
+     *
+     * @param threshold Condition estimate above which to damp. Zero disables the damping.
+     * @param damping Maximal \f$ \lambda^2 \f$
+     */
+    void setSingularityDamping(double threshold, double damping);
+
+    /**
+     * @brief Get the condition estimate of the last factorization
+     *
+     * This is the ratio of the largest and smallest pivots of the solver's
+     * \f$ LDL^T \f$ factorization, a cheap lower bound of the condition
+     * number. Large values indicate a nearby singularity.
+     *
+     * @return The estimate, or zero if the solver hasn't factorized yet
+     */
+    double getConditionEstimate() const;
+
+    //! Get the \f$ \lambda^2 \f$ currently added near singularities
+    double getSingularityDamping() const;
+
+  protected:
+    /**
+     * @brief Compute all kinematic quantities of the current joint state
+     *
+     * Called whenever the joint state has changed. The default computes the
+     * kinematics with \ref computeKinematics.
+     */
+    virtual void computeChainQuantities();
+
+    /**
+     * @brief Walk the chain once for the current joint state
+     *
+     * Computes all segment frames, the end effector pose and velocity and,
+     * if the cached one is outdated, the joint Jacobian. This replaces the
+     * separate passes of KDL's forward kinematics and Jacobian solvers.
+     *
+     * @param inertia If given, also compute the joint space inertia matrix
+     * of the chain in the same pass. This always recomputes the Jacobian.
+     *
+     * @return True if the Jacobian was recomputed
+     */
+    bool computeKinematics(KDL::JntSpaceInertiaMatrix* inertia = NULL);
+
+    /**
+     * @brief Keep the current joint positions within their limits
+     *
+     * @return True if any joint was clamped
+     */
+    bool clampPositions();
+
+    /**
+     * @brief Scale the given velocities into the velocity and acceleration limits
+     *
+     * @param last_velocities The velocities of the last control cycle
+     * @param dt The time to reach the given velocities in sec
+     * @param velocities The velocities to limit
+     *
+     * @return True if the velocities were limited
+     */
+    bool limitVelocities(const KDL::JntArray& last_velocities,
+                         double dt,
+                         KDL::JntArray& velocities) const;
+
+    /**
+     * @brief Store the condition estimate and compute the resulting damping
+     *
+     * @param estimate The condition estimate of the undamped system
+     *
+     * @return The \f$ \lambda^2 \f$ to add to the system's diagonal, zero if
+     * the system is well-conditioned
+     */
+    double updateSingularityDamping(double estimate);
+
+    //! The underlying physical system
+    KDL::Chain m_chain;
+
+    //! Number of controllable joint
+    int m_number_joints;
+
+    // Internal buffers
+    KDL::JntArray m_current_positions;
+    KDL::JntArray m_current_velocities;
+    KDL::JntArray m_current_accelerations;
+    KDL::JntArray m_last_positions;
+    KDL::JntArray m_last_velocities;
+
+    // Joint limits
+    KDL::JntArray m_upper_pos_limits;
+    KDL::JntArray m_lower_pos_limits;
+    KDL::JntArray m_max_velocities;
+    KDL::JntArray m_max_accelerations;
+    bool          m_motion_limits;      //!< True if any velocity or acceleration limit is finite
+
+    // Singularity damping
+    double        m_singularity_threshold;
+    double        m_max_singularity_damping;
+    double        m_condition_estimate;
+    double        m_singularity_damping;  //!< Last added \f$ \lambda^2 \f$
+
+    // Forward kinematics
+    std::vector<KDL::Frame>             m_segment_frames; //!< Tip frames of all segments w. r. t. base
+    KDL::Frame                          m_end_effector_pose;
+    ctrl::Vector6D                      m_end_effector_vel;
+    bool                                m_chain_quantities_valid;
+
+    // Jacobian
+    KDL::Jacobian                       m_jnt_jacobian;
+    KDL::JntArray                       m_jacobian_positions;
+    double                              m_jacobian_threshold;
+    bool                                m_jacobian_valid;
+};
+
+
+} // namespace
+
+#include "IKSolver.hpp"
+
+#endif
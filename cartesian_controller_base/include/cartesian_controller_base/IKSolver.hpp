@@ -29,7 +29,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 //-----------------------------------------------------------------------------
-/*!\file    ForwardDynamicsSolver.hpp
+/*!\file    IKSolver.hpp
  *
  * \author  Stefan Scherzinger <scherzin@fzi.de>
  * \date    2019/10/09
@@ -39,37 +39,31 @@
 
 
 // this package
-#include <cartesian_controller_base/ForwardDynamicsSolver.h>
+#include <cartesian_controller_base/IKSolver.h>
 
 // ROS control
 #include <hardware_interface/joint_command_interface.h>
+#include <hardware_interface/posvel_command_interface.h>
+#include <hardware_interface/posvelacc_command_interface.h>
 
 namespace cartesian_controller_base{
 
 template <>
-void ForwardDynamicsSolver::updateKinematics<hardware_interface::PositionJointInterface>(
-    const std::vector<hardware_interface::JointHandle>&)
+inline void IKSolver::updateKinematics<hardware_interface::PositionJointInterface>(
+    const std::vector<hardware_interface::JointStateHandle>&)
 {
   // Keep feed forward simulation running
   m_last_positions = m_current_positions;
+  m_last_velocities = m_current_velocities;
 
-  // Pose w. r. t. base
-  m_fk_pos_solver->JntToCart(m_current_positions,m_end_effector_pose);
-
-  // Absolute velocity w. r. t. base
-  KDL::FrameVel vel;
-  m_fk_vel_solver->JntToCart(KDL::JntArrayVel(m_current_positions,m_current_velocities),vel);
-  m_end_effector_vel[0] = vel.deriv().vel.x();
-  m_end_effector_vel[1] = vel.deriv().vel.y();
-  m_end_effector_vel[2] = vel.deriv().vel.z();
-  m_end_effector_vel[3] = vel.deriv().rot.x();
-  m_end_effector_vel[4] = vel.deriv().rot.y();
-  m_end_effector_vel[5] = vel.deriv().rot.z();
+  // Pose and absolute velocity w. r. t. base, together with what the
+  // solver needs for the next step
+  computeChainQuantities();
 }
 
 template <>
-void ForwardDynamicsSolver::updateKinematics<hardware_interface::VelocityJointInterface>(
-    const std::vector<hardware_interface::JointHandle>& joint_handles)
+inline void IKSolver::updateKinematics<hardware_interface::VelocityJointInterface>(
+    const std::vector<hardware_interface::JointStateHandle>& joint_handles)
 {
   // Reset internal simulation with real robot state
   setStartState(joint_handles);
@@ -77,4 +71,28 @@ void ForwardDynamicsSolver::updateKinematics<hardware_interface::VelocityJointIn
   updateKinematics<hardware_interface::PositionJointInterface>(joint_handles);
 }
 
+template <>
+inline void IKSolver::updateKinematics<hardware_interface::PosVelJointInterface>(
+    const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+{
+  // Feed forward simulation as for position commands
+  updateKinematics<hardware_interface::PositionJointInterface>(joint_handles);
+}
+
+template <>
+inline void IKSolver::updateKinematics<hardware_interface::PosVelAccJointInterface>(
+    const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+{
+  // Feed forward simulation as for position commands
+  updateKinematics<hardware_interface::PositionJointInterface>(joint_handles);
+}
+
+template <>
+inline void IKSolver::updateKinematics<hardware_interface::EffortJointInterface>(
+    const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+{
+  // Feedback from the real robot as for velocity commands
+  updateKinematics<hardware_interface::VelocityJointInterface>(joint_handles);
+}
+
 }
@@ -28,87 +28,74 @@
 // POSSIBILITY OF SUCH DAMAGE.
 ////////////////////////////////////////////////////////////////////////////////
 
-
 //-----------------------------------------------------------------------------
-/*!\file    PDController.h
+/*!\file    LatencyHistogram.h
  *
- * \author  Stefan Scherzinger <scherzin@fzi.de>
- * \date    2019/10/16
+ * \author  agent <agent@local>
+ * \date    2026/10/14
  *
  */
 //-----------------------------------------------------------------------------
 
-#ifndef PD_CONTROLLER_H_INCLUDED
-#define PD_CONTROLLER_H_INCLUDED
+#ifndef LATENCY_HISTOGRAM_H_INCLUDED
+#define LATENCY_HISTOGRAM_H_INCLUDED
 
 // ROS
 #include <ros/ros.h>
 
-// ros_control
-#include <realtime_tools/realtime_buffer.h>
-#include <realtime_tools/realtime_box.h>
-
-// Dynamic reconfigure
-#include <dynamic_reconfigure/server.h>
-#include <cartesian_controller_base/PDGainsConfig.h>
-
 namespace cartesian_controller_base
 {
 
 /**
- * @brief A proportional, derivative controller
- *
- * Motivation for this custom implementation:
+ * @brief A fixed-size histogram of execution times
  *
- *  - Restriction to meaningful parameter ranges.
- *  Users should be able to use the sliders in dynamic
- *  reconfigure to find suitable parameters for their setup.
- *
- *  - No integral gain.
- *  The \ref cartesian_controllers package builds upon a control plant that
- *  already has an integrating part to eliminate steady state errors.
- *  Additionally exposing I-related parameters in dynamic reconfigure distracts
- *  users with unused complexity.
+ * Samples are sorted into buckets with power-of-two upper bounds, starting at
+ * one microsecond. The last bucket collects everything above. Adding samples
+ * neither allocates nor locks, so that this class can be used in the control
+ * loop. Copy it to hand it over to other threads.
  */
-class PDController
+class LatencyHistogram
 {
   public:
-    PDController();
-    PDController(const PDController& other); ///< RealtimeBuffer needs special treatment
-    ~PDController();
-
-    void init(const std::string& name_space);
+    //! Buckets up to 2^15 us and one for all longer samples
+    static const int NUMBER_BUCKETS = 17;
 
-    double operator()(const double& error, const ros::Duration& period);
+    LatencyHistogram();
 
-  private:
-    struct PDGains
-    {
-      PDGains()
-        : m_p(0), m_d(0)
-      {};
+    //! Sort a new sample into the histogram
+    void add(const ros::WallDuration& latency);
 
-      PDGains(double p, double d)
-        : m_p(p), m_d(d)
-      {};
+    //! Remove all samples
+    void reset();
 
-      double m_p; ///< proportional gain
-      double m_d; ///< derivative gain
-    };
+    //! Number of samples so far
+    unsigned long count() const;
 
-    realtime_tools::RealtimeBuffer<PDGains> m_gains;
+    //! Mean of all samples in seconds
+    double mean() const;
 
-    double m_last_p_error;
+    //! Longest sample so far in seconds
+    double max() const;
 
-    // Dynamic reconfigure
-    typedef cartesian_controller_base::PDGainsConfig PDGainsConfig;
-    void dynamicReconfigureCallback(PDGainsConfig& config, uint32_t level);
+    //! Number of samples in the given bucket
+    unsigned long bucket(int i) const;
 
-    boost::shared_ptr<dynamic_reconfigure::Server<PDGainsConfig> > m_dyn_conf_server;
-    dynamic_reconfigure::Server<PDGainsConfig>::CallbackType m_callback_type;
+    /**
+     * @brief Get the upper bound of the given bucket
+     *
+     * @param i The bucket index
+     *
+     * @return The bound in seconds. The last bucket has no bound and returns a negative value.
+     */
+    static double bucketUpperBound(int i);
 
+  private:
+    unsigned long m_buckets[NUMBER_BUCKETS];
+    unsigned long m_count;
+    double        m_sum;
+    double        m_max;
 };
 
-}
+} // namespace
 
 #endif
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    MultiArmController.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef MULTI_ARM_CONTROLLER_H_INCLUDED
+#define MULTI_ARM_CONTROLLER_H_INCLUDED
+
+// ROS
+#include <ros/node_handle.h>
+
+// ros_controls
+#include <controller_interface/controller.h>
+
+// Project
+#include <cartesian_controller_base/WorkerPool.h>
+
+// Other
+#include <vector>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief Run one Cartesian controller per arm in parallel
+ *
+ * Each arm is a complete controller of type \a ArmController, with its own
+ * solver for its own robot_base_link and end_effector_link. The arms are
+ * configured in the sub-namespaces listed in the \a arms parameter. On each
+ * control cycle, all arms are updated in parallel by a \ref WorkerPool.
+ * The first arm runs in the control loop's thread, every other arm in its own
+ * preallocated worker thread. This controller's update returns when all arms
+ * have written their joint commands, so that the hardware gets consistent
+ * commands for all arms.
+ *
+ * The optional parameters \a worker_cpus and \a worker_priority pin the
+ * workers to CPU cores and give them a SCHED_FIFO priority.
+ *
+ * The arms get initialized with the robot hardware as single controllers
+ * from the controller manager. They can therefore use further hardware
+ * interfaces, such as force-torque sensors.
+ *
+ * @tparam HardwareInterface The interface to support. One of those of
+ * cartesian_controller_base::CartesianControllerBase
+ * @tparam ArmController The controller for each arm, using the same HardwareInterface
+ */
+template <class HardwareInterface, class ArmController>
+class MultiArmController : public controller_interface::Controller<HardwareInterface>
+{
+  public:
+    MultiArmController();
+
+    virtual void starting(const ros::Time& time);
+
+    virtual void stopping(const ros::Time& time);
+
+    virtual void update(const ros::Time& time, const ros::Duration& period);
+
+  protected:
+    /**
+     * @brief Initialize all arms with the robot hardware
+     *
+     * Forwards the robot hardware to each arm's own initRequest and merges
+     * the resources that all arms claim.
+     */
+    virtual bool initRequest(hardware_interface::RobotHW* robot_hw,
+                             ros::NodeHandle&             root_nh,
+                             ros::NodeHandle&             controller_nh,
+                             controller_interface::ControllerBase::ClaimedResources& claimed_resources);
+
+  private:
+    //! Task for the worker pool
+    void updateArm(int arm);
+
+    std::vector<boost::shared_ptr<ArmController> >  m_arms;
+    WorkerPool                                      m_workers;
+
+    // Arguments for the arms' update in this cycle
+    ros::Time                                       m_time;
+    ros::Duration                                   m_period;
+};
+
+}
+
+#include <cartesian_controller_base/MultiArmController.hpp>
+
+#endif
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    MultiArmController.hpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef MULTI_ARM_CONTROLLER_HPP_INCLUDED
+#define MULTI_ARM_CONTROLLER_HPP_INCLUDED
+
+// Project
+#include <cartesian_controller_base/MultiArmController.h>
+
+// Other
+#include <boost/bind.hpp>
+
+namespace cartesian_controller_base
+{
+
+template <class HardwareInterface, class ArmController>
+MultiArmController<HardwareInterface, ArmController>::
+MultiArmController()
+{
+}
+
+template <class HardwareInterface, class ArmController>
+bool MultiArmController<HardwareInterface, ArmController>::
+initRequest(hardware_interface::RobotHW* robot_hw,
+            ros::NodeHandle&             root_nh,
+            ros::NodeHandle&             nh,
+            controller_interface::ControllerBase::ClaimedResources& claimed_resources)
+{
+  if (this->state_ != controller_interface::ControllerBase::CONSTRUCTED)
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << ": The multi-arm controller is already initialized");
+    return false;
+  }
+
+  std::vector<std::string> arm_names;
+  if (!nh.getParam("arms",arm_names) || arm_names.empty())
+  {
+    ROS_ERROR_STREAM("Failed to load " << nh.getNamespace() + "/arms" << " from parameter server");
+    return false;
+  }
+
+  // Each arm reads its configuration from its own namespace and takes what
+  // it needs from the robot hardware, as a single controller would
+  claimed_resources.clear();
+  std::vector<WorkerPool::Task> tasks;
+  for (size_t i = 0; i < arm_names.size(); ++i)
+  {
+    ros::NodeHandle arm_nh(nh,arm_names[i]);
+    boost::shared_ptr<ArmController> arm(new ArmController());
+    controller_interface::ControllerBase::ClaimedResources arm_resources;
+    controller_interface::ControllerBase& arm_base = *arm;
+    if (!arm_base.initRequest(robot_hw,root_nh,arm_nh,arm_resources))
+    {
+      ROS_ERROR_STREAM("Failed to initialize arm " << arm_nh.getNamespace());
+      return false;
+    }
+    m_arms.push_back(arm);
+    tasks.push_back(boost::bind(
+          &MultiArmController<HardwareInterface, ArmController>::updateArm, this, i));
+
+    // Merge the claims per hardware interface
+    for (size_t j = 0; j < arm_resources.size(); ++j)
+    {
+      size_t k = 0;
+      while (k < claimed_resources.size() &&
+             claimed_resources[k].hardware_interface != arm_resources[j].hardware_interface)
+      {
+        ++k;
+      }
+      if (k == claimed_resources.size())
+      {
+        claimed_resources.push_back(arm_resources[j]);
+      }
+      else
+      {
+        claimed_resources[k].resources.insert(
+            arm_resources[j].resources.begin(),arm_resources[j].resources.end());
+      }
+    }
+  }
+
+  std::vector<int> worker_cpus;
+  int worker_priority;
+  nh.getParam("worker_cpus",worker_cpus);
+  nh.param("worker_priority",worker_priority,0);
+  if (!m_workers.init(tasks,worker_cpus,worker_priority))
+  {
+    ROS_WARN_STREAM(nh.getNamespace() << ": Workers run without the requested CPU pinning or priority");
+  }
+
+  this->state_ = controller_interface::ControllerBase::INITIALIZED;
+  return true;
+}
+
+template <class HardwareInterface, class ArmController>
+void MultiArmController<HardwareInterface, ArmController>::
+starting(const ros::Time& time)
+{
+  for (size_t i = 0; i < m_arms.size(); ++i)
+  {
+    m_arms[i]->starting(time);
+  }
+}
+
+template <class HardwareInterface, class ArmController>
+void MultiArmController<HardwareInterface, ArmController>::
+stopping(const ros::Time& time)
+{
+  for (size_t i = 0; i < m_arms.size(); ++i)
+  {
+    m_arms[i]->stopping(time);
+  }
+}
+
+template <class HardwareInterface, class ArmController>
+void MultiArmController<HardwareInterface, ArmController>::
+update(const ros::Time& time, const ros::Duration& period)
+{
+  // The workers see these after the wake-up in run()
+  m_time = time;
+  m_period = period;
+
+  m_workers.run();
+}
+
+template <class HardwareInterface, class ArmController>
+void MultiArmController<HardwareInterface, ArmController>::
+updateArm(int arm)
+{
+  m_arms[arm]->update(m_time,m_period);
+}
+
+} // namespace
+
+#endif
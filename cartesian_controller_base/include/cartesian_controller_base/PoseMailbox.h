@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    PoseMailbox.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef POSE_MAILBOX_H_INCLUDED
+#define POSE_MAILBOX_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/SeqLock.h>
+
+// ROS
+#include <ros/time.h>
+
+// KDL
+#include <kdl/frames.hpp>
+
+// Other
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief A lock-free channel for target poses between controllers
+ *
+ * Controllers in the same controller manager share one process. Producers of
+ * target poses, such as the joint_to_cartesian_controller, write to a mailbox
+ * in their update(), and Cartesian controllers read from it in theirs.
+ * There is no serialization and no hop through a ROS spinner in between.
+ *
+ * Mailboxes are identified by the resolved name of the topic that the
+ * producer also publishes on, and by the reference frame of the poses.
+ * Consumers in other processes and producers with a different reference
+ * frame use the topic as before.
+ *
+ * \ref write and \ref read are real-time safe and never block. They use a
+ * \ref SeqLock: readers retry a few times if a write is in progress,
+ * and concurrent writers skip their write.
+ */
+class PoseMailbox
+{
+  public:
+    typedef boost::shared_ptr<PoseMailbox> Ptr;
+
+    /**
+     * @brief Get the process-wide mailbox for the given topic and frame
+     *
+     * Not real-time safe. Call this in init().
+     *
+     * @param topic The fully resolved topic name
+     * @param frame_id The reference frame of the poses
+     *
+     * @return The mailbox, which gets created on first use
+     */
+    static Ptr get(const std::string& topic, const std::string& frame_id);
+
+    /**
+     * @brief Store a new pose
+     *
+     * @param frame The pose in the mailbox's reference frame
+     * @param stamp The time of the pose
+     */
+    void write(const KDL::Frame& frame, const ros::Time& stamp);
+
+    /**
+     * @brief Read the pose, if there is a new one
+     *
+     * @param frame The latest pose
+     * @param stamp The latest pose's time
+     * @param sequence The sequence number of the last read pose. Gets
+     * updated on success. Use \ref sequence for the first call.
+     *
+     * @return True if a new pose was read
+     */
+    bool read(KDL::Frame& frame, ros::Time& stamp, unsigned long& sequence) const;
+
+    //! Current sequence number. Zero if no pose was ever written.
+    unsigned long sequence() const;
+
+    /**
+     * @brief Whether a producer wrote within the given timeout
+     *
+     * Use this to ignore the producer's duplicates on the topic.
+     */
+    bool isActive(const ros::Time& now, const ros::Duration& timeout) const;
+
+  private:
+    struct Sample
+    {
+      KDL::Frame frame;
+      ros::Time stamp;
+    };
+
+    SeqLock<Sample>             m_samples;
+
+    static std::map<std::string, Ptr> s_mailboxes;
+    static boost::mutex               s_mutex;
+};
+
+} // namespace
+
+#endif
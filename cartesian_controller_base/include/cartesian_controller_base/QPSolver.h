@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    QPSolver.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef QP_SOLVER_H_INCLUDED
+#define QP_SOLVER_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/DampedLeastSquaresSolver.h>
+
+// other
+#include <vector>
+
+namespace cartesian_controller_base{
+
+/*! \brief Damped least squares velocity inverse kinematics with joint limits
+ *
+ *  Like the \ref DampedLeastSquaresSolver, but the joint limits are
+ *  constraints of the optimization instead of being clamped afterwards:
+ *
+ *  \f$ \min_{\dot{q}} \| J \dot{q} - \dot{x} \|^2 + \lambda^2 \| \dot{q} \|^2 \f$
+ *  subject to \f$ q_{min} \le q + \dot{q} \, dt \le q_{max} \f$
+ *
+ *  Joints that would hit their limits stop there, and the other joints take
+ *  over as much of the end effector motion as possible. The box-constrained
+ *  problem is solved exactly with a primal active set method. All buffers
+ *  are allocated in \ref init.
+ */
+class QPSolver : public DampedLeastSquaresSolver
+{
+  public:
+    QPSolver();
+    ~QPSolver();
+
+    /**
+     * @brief Initialize the solver
+     *
+     * @param chain The kinematic chain of the robot
+     * @param upper_pos_limits Tuple with max positive joint angles
+     * @param lower_pos_limits Tuple with max negative joint angles
+     *
+     * @return True, if everything went well
+     */
+    bool init(const KDL::Chain& chain,
+              const KDL::JntArray& upper_pos_limits,
+              const KDL::JntArray& lower_pos_limits);
+
+  protected:
+    void computeJointVelocities(
+        const ctrl::Vector6D& cartesian_velocity,
+        double dt,
+        KDL::JntArray& velocities);
+
+  private:
+    //! Activity of each joint's bounds
+    enum Bound
+    {
+      FREE,
+      AT_LOWER,
+      AT_UPPER
+    };
+
+    ctrl::MatrixND                m_hessian;          ///< \f$ J^T J + \lambda^2 I \f$
+    ctrl::VectorND                m_gradient;         ///< \f$ J^T \dot{x} \f$
+    ctrl::VectorND                m_lower;            ///< Velocity bounds of this step
+    ctrl::VectorND                m_upper;
+    ctrl::MatrixND                m_reduced_hessian;  ///< Hessian with the active joints fixed
+    ctrl::VectorND                m_reduced_gradient;
+    ctrl::VectorND                m_candidate;
+    ctrl::VectorND                m_residual;
+    Eigen::LDLT<ctrl::MatrixND>   m_decomposition;
+    std::vector<Bound>            m_bounds;
+};
+
+} // namespace
+
+#endif
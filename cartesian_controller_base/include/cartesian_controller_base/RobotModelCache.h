@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    RobotModelCache.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef ROBOT_MODEL_CACHE_H_INCLUDED
+#define ROBOT_MODEL_CACHE_H_INCLUDED
+
+// KDL
+#include <kdl/tree.hpp>
+#include <kdl/chain.hpp>
+
+// URDF
+#include <urdf/model.h>
+
+// Other
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief A process-wide cache of parsed robot models
+ *
+ * Each controller parses \a /robot_description into a URDF model, a KDL tree
+ * and a chain during init(). All controller plugins share one process
+ * with the controller manager, so this class does the parsing once per robot
+ * description and hands out immutable, shared results to everyone else.
+ *
+ * Robot descriptions are identified by their hash and compared in full, so
+ * that a changed description gets parsed again. Chains are cached per pair of
+ * base and tip link. All functions are thread-safe, but not real-time safe.
+ * Use them during init() only.
+ */
+class RobotModelCache
+{
+  public:
+    typedef boost::shared_ptr<const urdf::Model>  UrdfPtr;
+    typedef boost::shared_ptr<const KDL::Tree>    TreePtr;
+    typedef boost::shared_ptr<const KDL::Chain>   ChainPtr;
+
+    /**
+     * @brief Get the URDF model of the given robot description
+     *
+     * @param robot_description The content of the URDF file
+     *
+     * @return The parsed model or a null pointer if parsing failed
+     */
+    static UrdfPtr getUrdf(const std::string& robot_description);
+
+    /**
+     * @brief Get the KDL tree of the given robot description
+     *
+     * @param robot_description The content of the URDF file
+     *
+     * @return The tree or a null pointer if parsing failed
+     */
+    static TreePtr getTree(const std::string& robot_description);
+
+    /**
+     * @brief Get the KDL chain between two links of the given robot description
+     *
+     * @param robot_description The content of the URDF file
+     * @param base_link The root link of the chain
+     * @param tip_link The tip link of the chain
+     *
+     * @return The chain or a null pointer if parsing failed or the links don't exist
+     */
+    static ChainPtr getChain(
+        const std::string& robot_description,
+        const std::string& base_link,
+        const std::string& tip_link);
+
+  private:
+    //! Everything that is parsed from one robot description
+    struct Entry
+    {
+      std::string                       robot_description;
+      UrdfPtr                           urdf;
+      TreePtr                           tree;
+      std::map<std::string, ChainPtr>   chains;  ///< Keyed by "base_link tip_link"
+    };
+
+    /**
+     * @brief Get the cache entry for the given description and parse if it's new
+     *
+     * Call with \ref s_mutex locked.
+     */
+    static Entry& getEntry(const std::string& robot_description);
+
+    static std::map<std::size_t, Entry> s_entries;
+    static boost::mutex                 s_mutex;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    SeqLock.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef SEQ_LOCK_H_INCLUDED
+#define SEQ_LOCK_H_INCLUDED
+
+// Other
+#include <boost/atomic.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief Lock-free handover of the latest value between threads
+ *
+ * A sequence lock. Neither side blocks or allocates, as long as the
+ * value's type doesn't allocate on copy assignment. Dynamically sized
+ * types, such as KDL::JntArray, must therefore be sized with \ref init
+ * before use.
+ *
+ * Readers may miss intermediate values and retry a few times if a write
+ * is in progress. They keep their last value if that fails. Concurrent
+ * writers skip their write.
+ */
+template <class T>
+class SeqLock
+{
+  public:
+    SeqLock() : m_sequence(0) {}
+
+    /**
+     * @brief Set the initial value
+     *
+     * Not real-time safe. Call this before the threads start.
+     */
+    void init(const T& value)
+    {
+      m_value = value;
+      m_sequence.store(0, boost::memory_order_release);
+    }
+
+    /**
+     * @brief Store a new value
+     *
+     * @return False if the write was skipped because another writer is busy
+     */
+    bool write(const T& value)
+    {
+      // Mark the write as in progress. Skip if another writer is busy.
+      unsigned long sequence = m_sequence.load(boost::memory_order_relaxed);
+      if ((sequence & 1) ||
+          !m_sequence.compare_exchange_strong(sequence, sequence + 1, boost::memory_order_acquire))
+      {
+        return false;
+      }
+      boost::atomic_thread_fence(boost::memory_order_release);
+
+      m_value = value;
+
+      m_sequence.store(sequence + 2, boost::memory_order_release);
+      return true;
+    }
+
+    /**
+     * @brief Read the latest value, if there is a new one
+     *
+     * @param value Gets the latest value on success
+     * @param sequence The sequence number of the last read value. Gets
+     * updated on success. Start with zero or \ref sequence.
+     * @param scratch The reader's copy, so that torn reads never reach
+     * \a value. Must be sized like the written values.
+     *
+     * @return True if a new value was read
+     */
+    bool read(T& value, unsigned long& sequence, T& scratch) const
+    {
+      for (int attempt = 0; attempt < 3; ++attempt)
+      {
+        const unsigned long begin = m_sequence.load(boost::memory_order_acquire);
+        if (begin == sequence)
+        {
+          return false;
+        }
+        if (begin & 1)
+        {
+          continue;
+        }
+
+        scratch = m_value;
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+
+        // Only use the copy if no write happened in the meantime
+        if (m_sequence.load(boost::memory_order_relaxed) == begin)
+        {
+          value = scratch;
+          sequence = begin;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //! Current sequence number. Zero if nothing was written since \ref init.
+    unsigned long sequence() const
+    {
+      return m_sequence.load(boost::memory_order_acquire) & ~1ul;
+    }
+
+  private:
+    T                             m_value;
+    boost::atomic<unsigned long>  m_sequence; ///< Odd while a write is in progress
+};
+
+} // namespace
+
+#endif
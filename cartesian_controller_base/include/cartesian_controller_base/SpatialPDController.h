@@ -42,19 +42,32 @@
 
 // Project
 #include <cartesian_controller_base/Utility.h>
-#include <cartesian_controller_base/PDController.h>
 
 // ROS
 #include <ros/ros.h>
 
+// ros_control
+#include <realtime_tools/realtime_buffer.h>
+
+// Dynamic reconfigure
+#include <dynamic_reconfigure/server.h>
+#include <cartesian_controller_base/SpatialPDGainsConfig.h>
+
 namespace cartesian_controller_base
 {
 
 /**
  * @brief A 6-dimensional PD controller class
  *
- * This class implements separate PD controllers for each of the Cartesian
- * axes, i.e. three translational controllers and three rotational controllers.
+ * This class implements PD control for all Cartesian axes at once, i.e.
+ * three translational and three rotational axes.  The gains of all axes are
+ * read once per call and applied with one vector expression.
+ *
+ * By default, the axes are decoupled and each has its own proportional and
+ * derivative gain.  Optionally, full 6x6 gain matrices can be given with the
+ * \a pd_gains/p_matrix and \a pd_gains/d_matrix parameters (row-major, 36
+ * values) to couple axes.  The dynamic reconfigure gains then overwrite the
+ * matrices' diagonals.
  */
 class SpatialPDController
 {
@@ -73,9 +86,59 @@ class SpatialPDController
      */
     ctrl::Vector6D operator()(const ctrl::Vector6D& error, const ros::Duration& period);
 
+    /**
+     * @brief Start the derivative part anew with the next error
+     *
+     * The next call then only applies the proportional part, which avoids
+     * a derivative kick from the error of a previous activation.
+     */
+    void reset();
+
+    /**
+     * @brief Take the latest gains for the next calls
+     *
+     * Call this once per control cycle, so that all solver iterations of
+     * that cycle use the same gains.
+     */
+    void updateGains();
+
   private:
+    struct Gains
+    {
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      Gains()
+        : p(ctrl::Vector6D::Zero())
+        , d(ctrl::Vector6D::Zero())
+        , p_matrix(ctrl::Matrix6D::Zero())
+        , d_matrix(ctrl::Matrix6D::Zero())
+        , coupled(false)
+      {};
+
+      ctrl::Vector6D p;         ///< proportional gains of decoupled axes
+      ctrl::Vector6D d;         ///< derivative gains of decoupled axes
+      ctrl::Matrix6D p_matrix;  ///< proportional gains of coupled axes
+      ctrl::Matrix6D d_matrix;  ///< derivative gains of coupled axes
+      bool coupled;
+    };
+
+    //! Load an optional 6x6 gain matrix from the parameter server
+    bool loadGainMatrix(ros::NodeHandle& nh, const std::string& name, ctrl::Matrix6D& matrix);
+
+    realtime_tools::RealtimeBuffer<Gains> m_gains;
+    Gains m_config_gains; ///< Latest gains from dynamic reconfigure
+    const Gains* m_active_gains; ///< Gains of the current control cycle
+
     ctrl::Vector6D m_cmd;
-    std::vector<PDController> m_pd_controllers;
+    ctrl::Vector6D m_last_p_error;
+    bool m_reset;
+
+    // Dynamic reconfigure
+    typedef cartesian_controller_base::SpatialPDGainsConfig SpatialPDGainsConfig;
+    void dynamicReconfigureCallback(SpatialPDGainsConfig& config, uint32_t level);
+
+    boost::shared_ptr<dynamic_reconfigure::Server<SpatialPDGainsConfig> > m_dyn_conf_server;
+    dynamic_reconfigure::Server<SpatialPDGainsConfig>::CallbackType m_callback_type;
 
 };
 
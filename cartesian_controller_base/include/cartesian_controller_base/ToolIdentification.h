@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    ToolIdentification.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef TOOL_IDENTIFICATION_H_INCLUDED
+#define TOOL_IDENTIFICATION_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief Identify the mass and the center of mass of a tool online
+ *
+ * Without contact, a force-torque sensor measures the tool's weight and its
+ * own offsets. For the gravity \f$ g \f$ in the sensor frame:
+ * \f[
+ *   f = m g + f_0, \qquad \tau = (m c) \times g + \tau_0
+ * \f]
+ * Both are linear in the unknowns. This class estimates them with two
+ * recursive least squares filters, one for each equation.  In contrast to
+ * the offsets, the mass and the center of mass \f$ c \f$ only become
+ * observable if the tool takes several different orientations.
+ *
+ * All methods are real-time safe.
+ */
+class ToolIdentification
+{
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param forgetting_factor Weight of old samples per update, in (0, 1].
+     * One means to weigh all samples equally.
+     */
+    ToolIdentification(double forgetting_factor = 1.0);
+
+    //! Start anew without prior samples
+    void reset();
+
+    /**
+     * @brief Add a sample
+     *
+     * @param gravity The gravity vector in the sensor frame
+     * @param wrench The measured wrench in the sensor frame, including offsets
+     */
+    void update(const ctrl::Vector3D& gravity, const ctrl::Vector6D& wrench);
+
+    //! The estimated mass
+    double mass() const {return m_force_estimate[0];}
+
+    //! The estimated center of mass in the sensor frame
+    ctrl::Vector3D centerOfMass() const;
+
+    /**
+     * @brief Whether the estimate is reliable
+     *
+     * This requires a positive mass and sufficiently different orientations
+     * of the tool, such that the estimate's uncertainty dropped well below
+     * its initial value.
+     */
+    bool converged() const;
+
+    //! Number of samples since the last reset
+    unsigned long samples() const {return m_samples;}
+
+  private:
+    typedef Eigen::Matrix<double,4,1> Vector4D;
+    typedef Eigen::Matrix<double,4,4> Matrix4D;
+    typedef Eigen::Matrix<double,3,4> Matrix34D;
+    typedef Eigen::Matrix<double,3,6> Matrix36D;
+
+    double          m_forgetting_factor;
+    unsigned long   m_samples;
+
+    Vector4D        m_force_estimate;     ///< m, f_0
+    Matrix4D        m_force_covariance;
+    ctrl::Vector6D  m_torque_estimate;    ///< m c, tau_0
+    ctrl::Matrix6D  m_torque_covariance;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    WorkerPool.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef WORKER_POOL_H_INCLUDED
+#define WORKER_POOL_H_INCLUDED
+
+// Other
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief A fixed set of tasks that run in parallel on each call of \ref run
+ *
+ * The first task runs in the calling thread. Each other task gets its own
+ * worker thread, which is started once in \ref init and waits for the next
+ * call of \ref run. Nothing gets allocated after initialization, so that \ref
+ * run can be called from the control loop. It returns once all tasks have
+ * finished.
+ */
+class WorkerPool
+{
+  public:
+    typedef boost::function<void ()> Task;
+
+    WorkerPool();
+    ~WorkerPool();
+
+    /**
+     * @brief Start the worker threads
+     *
+     * @param tasks The tasks to run on each call of \ref run
+     * @param cpus Optional CPU cores to pin the worker threads to, one for
+     * each task except the first. Leave empty to not pin the workers.
+     * @param priority Optional SCHED_FIFO priority of the worker threads.
+     * Zero keeps the default scheduling.
+     *
+     * @return True if all workers were started as requested
+     */
+    bool init(const std::vector<Task>& tasks,
+              const std::vector<int>& cpus = std::vector<int>(),
+              int priority = 0);
+
+    //! Run all tasks in parallel and wait for them to finish
+    void run();
+
+  private:
+    //! Thread function of the worker for the given task
+    void work(int task);
+
+    //! Stop and join all workers
+    void shutdown();
+
+    std::vector<Task>                               m_tasks;
+    std::vector<boost::shared_ptr<boost::thread> >  m_workers;
+
+    boost::mutex                m_mutex;
+    boost::condition_variable   m_start;
+    unsigned long               m_generation; ///< Number of calls to run()
+    bool                        m_shutdown;
+    boost::atomic<int>          m_pending;    ///< Workers still running
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    WrenchFilter.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef WRENCH_FILTER_H_INCLUDED
+#define WRENCH_FILTER_H_INCLUDED
+
+// Project
+#include <cartesian_controller_base/Utility.h>
+
+// ROS
+#include <ros/ros.h>
+
+namespace cartesian_controller_base
+{
+
+/**
+ * @brief A fixed-size filter stage for force-torque sensor samples
+ *
+ * Each sample first passes an optional median filter against spikes and then
+ * a linear low-pass filter in direct form II (transposed). All six axes are
+ * filtered independently with the same coefficients.  Filtering neither
+ * allocates nor locks, so that this class can be used in the control loop.
+ *
+ * The parameters are read from the given namespace:
+ * - \a median_window: Number of samples for the median (odd, default 1 = off).
+ * - \a b and \a a: Numerator and denominator coefficients of the low-pass.
+ *   Leave out \a a for a FIR filter.
+ * - \a cutoff_frequency and \a sample_rate: Alternatively, design a
+ *   second-order Butterworth low-pass with this cutoff in Hz.
+ *
+ * Without any of these, samples pass unchanged.
+ */
+class WrenchFilter
+{
+  public:
+    static const int MAX_MEDIAN_WINDOW = 9;
+    static const int MAX_ORDER = 8;
+
+    WrenchFilter();
+
+    bool init(ros::NodeHandle& nh);
+
+    /**
+     * @brief Filter the next sample
+     *
+     * The first sample after construction or \ref reset initializes the
+     * filter's state as if this sample had been constant for a long time.
+     *
+     * @param sample The new sensor sample
+     *
+     * @return The filtered sample
+     */
+    const ctrl::Vector6D& operator()(const ctrl::Vector6D& sample);
+
+    //! Start anew with the next sample
+    void reset();
+
+  private:
+    const ctrl::Vector6D& median(const ctrl::Vector6D& sample);
+    const ctrl::Vector6D& lowPass(const ctrl::Vector6D& sample);
+
+    //! Set coefficients and normalize them with a[0]
+    bool setCoefficients(const std::vector<double>& b, const std::vector<double>& a);
+
+    // Median filter
+    ctrl::Vector6D  m_window[MAX_MEDIAN_WINDOW];
+    int             m_window_size;
+    int             m_window_count;
+    int             m_window_index;
+    ctrl::Vector6D  m_median;
+
+    // Low-pass filter
+    double          m_b[MAX_ORDER + 1];
+    double          m_a[MAX_ORDER + 1];
+    ctrl::Vector6D  m_state[MAX_ORDER];
+    int             m_order;
+    ctrl::Vector6D  m_output;
+
+    bool            m_reset;
+};
+
+} // namespace
+
+#endif
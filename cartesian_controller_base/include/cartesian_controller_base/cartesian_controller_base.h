@@ -42,19 +42,26 @@
 
 // ROS
 #include <ros/node_handle.h>
-#include <trajectory_msgs/JointTrajectoryPoint.h>
 #include <geometry_msgs/WrenchStamped.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <std_srvs/Trigger.h>
 
 // ros_controls
 #include <controller_interface/controller.h>
 #include <hardware_interface/joint_command_interface.h>
+#include <hardware_interface/posvel_command_interface.h>
+#include <hardware_interface/posvelacc_command_interface.h>
+#include <realtime_tools/realtime_buffer.h>
+#include <realtime_tools/realtime_publisher.h>
 
 // KDL
-#include <kdl/treefksolverpos_recursive.hpp>
+#include <kdl/jntarrayvel.hpp>
 
 // Project
-#include <cartesian_controller_base/ForwardDynamicsSolver.h>
+#include <cartesian_controller_base/IKSolver.h>
 #include <cartesian_controller_base/SpatialPDController.h>
+#include <cartesian_controller_base/LatencyHistogram.h>
+#include <cartesian_controller_base/CycleRecorder.h>
 #include <cartesian_controller_base/Utility.h>
 
 // Dynamic reconfigure
@@ -64,7 +71,9 @@
 // Other
 #include <vector>
 #include <string>
+#include <map>
 #include <fstream>
+#include <boost/thread/mutex.hpp>
 
 namespace cartesian_controller_base
 {
@@ -72,13 +81,21 @@ namespace cartesian_controller_base
 /**
  * @brief Base class for each cartesian controller
  *
- * This class implements a common forward dynamics based solver for Cartesian
- * end effector error control, using the ROS-control framework.  Different
+ * This class implements a common solver for Cartesian end effector error
+ * control, using the ROS-control framework. The solver is forward dynamics
+ * based by default and can be chosen with the \a solver/type parameter, see
+ * \ref IKSolver::create.  Different
  * child class controllers will define what this error represents and should
  * call \ref computeJointControlCmds with that error.  The control commands are
  * sent to the hardware with \ref writeJointControlCmds.
  *
- * @tparam HardwareInterface The interface to support. Either PositionJointInterface or VelocityJointInterface
+ * With an EffortJointInterface, the solver is bypassed. The Cartesian input
+ * is then mapped to joint torques with the Jacobian's transpose of the real
+ * robot state.
+ *
+ * @tparam HardwareInterface The interface to support. One of
+ * PositionJointInterface, VelocityJointInterface, PosVelJointInterface,
+ * PosVelAccJointInterface or EffortJointInterface
  */
 template <class HardwareInterface>
 class CartesianControllerBase : public controller_interface::Controller<HardwareInterface>
@@ -100,21 +117,89 @@ class CartesianControllerBase : public controller_interface::Controller<Hardware
     /**
      * @brief Write joint control commands to the real hardware
      *
-     * Depending on the hardware interface used, this is either joint positions
-     * or velocities.
+     * Depending on the hardware interface used, this is either joint positions,
+     * velocities, both of them from the same solver step, or joint torques.
+     * The PosVelAccJointInterface additionally gets the joint accelerations
+     * since the last control cycle as feed forward.
      */
     void writeJointControlCmds();
 
     /**
-     * @brief Compute one control step using forward dynamics simulation
+     * @brief Publish the current joint control commands for debugging
+     *
+     * Publishing never blocks the control loop and is limited to the rate
+     * given by the \a publish_rate/cmd parameter. A rate of zero disables
+     * publishing. Call this once per control cycle.
+     *
+     * @param time The current time of the control cycle
+     */
+    void publishJointControlCmds(const ros::Time& time);
+
+    /**
+     * @brief Compute one control step with the configured solver
      *
-     * Check \ref ForwardDynamicsSolver for details.
+     * Check \ref IKSolver and its implementations for details.
      *
      * @param error The error to minimize
      * @param period The period for this control cycle
      */
     void computeJointControlCmds(const ctrl::Vector6D& error, const ros::Duration& period);
 
+    /**
+     * @brief Begin the solver iterations of a new control cycle
+     *
+     * Use this together with \ref continueIterations and \ref
+     * finishIterations around the calls of \ref computeJointControlCmds of
+     * each control cycle. The time in between is measured and compared to
+     * the period of the control cycle.
+     *
+     * This also applies the latest settings from dynamic reconfigure, so
+     * that they stay the same for all iterations of this cycle. Read
+     * \a m_settings only after this call. For the EffortJointInterface,
+     * this also updates the kinematics with the robot state of this cycle.
+     * Call it before anything that uses them, e.g. \ref getLinkFrame.
+     *
+     * @param period The period of the outer control cycle
+     */
+    void startIterations(const ros::Duration& period);
+
+    /**
+     * @brief Decide whether to compute another iteration in this cycle
+     *
+     * In adaptive mode, iterations stop early once the error is below the
+     * convergence tolerance, or when another iteration would likely exceed
+     * the cycle's time budget. Otherwise, this always returns true and the
+     * number of iterations is bounded by \a m_settings.iterations only.
+     *
+     * @param error The current error to minimize
+     *
+     * @return True if another iteration should be computed
+     */
+    bool continueIterations(const ctrl::Vector6D& error);
+
+    /**
+     * @brief Finish the iterations of this control cycle
+     *
+     * Turns the solver's result into this cycle's joint commands within the
+     * joints' velocity and acceleration limits and hands over the
+     * statistics of this cycle to the diagnostics. Call this before \ref
+     * writeJointControlCmds.
+     */
+    void finishIterations();
+
+    /**
+     * @brief Get the index of the given link for fast frame lookups
+     *
+     * Link names are resolved once. Use the index in the control loop to
+     * avoid string comparisons.
+     *
+     * @param link The name of the link. Must be the robot base link or
+     * any link of the chain up to the end effector link.
+     *
+     * @return The index for \ref displayInBaseLink and \ref displayInTipLink
+     */
+    int getLinkIndex(const std::string& link) const;
+
     /**
      * @brief Display the given vector in the given robot base link
      *
@@ -125,9 +210,15 @@ class CartesianControllerBase : public controller_interface::Controller<Hardware
      */
     ctrl::Vector6D displayInBaseLink(const ctrl::Vector6D& vector, const std::string& from);
 
+    //! Same as above with a link index from \ref getLinkIndex
+    ctrl::Vector6D displayInBaseLink(const ctrl::Vector6D& vector, int from);
+
     /**
      * @brief Display the given tensor in the robot base frame
      *
+     * Translational and rotational parts, including their coupling, get
+     * rotated alike. Not cheap. Call this once per control cycle where possible.
+     *
      * @param tensor The quantity to transform
      * @param from The reference frame where the quantity was formulated
      *
@@ -135,6 +226,9 @@ class CartesianControllerBase : public controller_interface::Controller<Hardware
      */
     ctrl::Matrix6D displayInBaseLink(const ctrl::Matrix6D& tensor, const std::string& from);
 
+    //! Same as above with a link index from \ref getLinkIndex
+    ctrl::Matrix6D displayInBaseLink(const ctrl::Matrix6D& tensor, int from);
+
     /**
      * @brief Display a given vector in a new reference frame
      *
@@ -147,24 +241,235 @@ class CartesianControllerBase : public controller_interface::Controller<Hardware
      */
     ctrl::Vector6D displayInTipLink(const ctrl::Vector6D& vector, const std::string& to);
 
-    boost::shared_ptr<KDL::TreeFkSolverPos_recursive>
-                            m_forward_kinematics_solver;
-    ForwardDynamicsSolver   m_forward_dynamics_solver;
+    //! Same as above with a link index from \ref getLinkIndex
+    ctrl::Vector6D displayInTipLink(const ctrl::Vector6D& vector, int to);
+
+    /**
+     * @brief Get the current frame of the given link
+     *
+     * The frames come from the solver's cache for the simulated joint
+     * state. Repeated lookups within one iteration are cheap.
+     *
+     * @param index The link index from \ref getLinkIndex
+     *
+     * @return The link's frame with respect to the robot base link
+     */
+    const KDL::Frame& getLinkFrame(int index);
+
+    /**
+     * @brief Get the orientation of the given link for the real joint state
+     *
+     * This walks the chain with the joint positions of the hardware,
+     * independent of the solver's simulated state. Call this once per
+     * control cycle, e.g. for quantities that depend on the real robot.
+     *
+     * @param index The link index from \ref getLinkIndex
+     *
+     * @return The link's orientation with respect to the robot base link
+     */
+    KDL::Rotation getMeasuredLinkOrientation(int index) const;
+
+    //! Record the target pose of this cycle, if recording is enabled
+    void recordTarget(const KDL::Frame& target);
+
+    //! Record the sensor wrench of this cycle, if recording is enabled
+    void recordWrench(const ctrl::Vector6D& wrench);
+
+    boost::shared_ptr<IKSolver> m_ik_solver;
     std::string             m_end_effector_link;
     std::string             m_robot_base_link;
+    int                     m_end_effector_link_index;
 
     bool m_paused;
-    int m_iterations;
+
+    /**
+     * @brief A consistent snapshot of all solver settings
+     *
+     * The reconfigure thread hands complete snapshots to the control loop,
+     * which takes the latest one in \ref startIterations.
+     */
+    struct SolverSettings
+    {
+      SolverSettings()
+        : version(0)
+        , error_scale(1.0)
+        , iterations(1)
+        , adaptive_iterations(false)
+        , convergence_tolerance(0.0)
+        , time_budget(0.0)
+        , internal_period(0.02)
+        , refactorization_threshold(0.0)
+        , jacobian_threshold(0.0)
+        , integrator(0)
+        , null_space_damping(0.5)
+        , damping(0.05)
+        , singularity_threshold(0.0)
+        , singularity_damping(0.01)
+      {};
+
+      unsigned long     version;          ///< Increases with each new snapshot
+      double            error_scale;
+      int               iterations;
+      bool              adaptive_iterations;
+      double            convergence_tolerance;
+      ros::WallDuration time_budget;
+      ros::Duration     internal_period;  ///< Simulated time of each solver iteration
+      double            refactorization_threshold;
+      double            jacobian_threshold;
+      int               integrator;
+      double            null_space_damping;
+      double            damping;
+      double            singularity_threshold;
+      double            singularity_damping;
+    };
+
+    SolverSettings m_settings;  ///< In use by the control loop
 
   private:
-    std::vector<hardware_interface::JointHandle>      m_joint_handles;
+    typedef typename HardwareInterface::ResourceHandleType JointCommandHandle;
+
+    /**
+     * @brief Turn the Cartesian input into joint motion
+     *
+     * Runs one step of the solver for all interfaces, except for the
+     * EffortJointInterface. That computes the joint torques instead.
+     *
+     * @param period The duration of this step
+     */
+    void computeJointMotion(const ros::Duration& period);
+
+    /**
+     * @brief Turn the solver's result into this cycle's joint commands
+     *
+     * Limits the motion since the last cycle's commands, once per control
+     * cycle and against its period. Position commands get the velocities
+     * and accelerations of this motion as feed forward terms. Joint torques
+     * are bounded by the effort limits.
+     */
+    void finishJointControlCmds();
+
+    /**
+     * @brief Update the solver's kinematics according to the interface
+     *
+     * Feed forward simulations continue after each solver step and velocity
+     * commands restart from the real robot state, see
+     * IKSolver::updateKinematics. Effort commands update once at the start
+     * of each cycle instead, with the robot state of that cycle.
+     *
+     * @param cycle_start True at the start of the control cycle, false
+     * after each solver step
+     */
+    void updateKinematics(bool cycle_start);
+
+    std::vector<hardware_interface::JointStateHandle> m_joint_handles;
+    std::vector<JointCommandHandle>                   m_joint_cmd_handles;
     std::vector<std::string>                          m_joint_names;
-    trajectory_msgs::JointTrajectoryPoint             m_simulated_joint_motion;
+    std::map<std::string, int>                        m_link_indices;
+    boost::shared_ptr<const KDL::Chain>               m_robot_chain;
+    KDL::Frame                                        m_base_link_frame;
+    KDL::JntArrayVel                                  m_simulated_joint_motion;
+    KDL::JntArray                                     m_last_cmd_positions;   //!< Of the previous control cycle
+    KDL::JntArray                                     m_last_cmd_velocities;  //!< Of the previous control cycle
+    KDL::JntArray                                     m_cmd_accelerations;
+    KDL::JntArray                                     m_joint_efforts;
+    KDL::JntArray                                     m_max_efforts;
     SpatialPDController                              m_spatial_controller;
     ctrl::Vector6D                                    m_cartesian_input;
     std::ofstream myfile;
-    double m_error_scale;
-    ros::Publisher pub;
+
+    //! Hand the solver settings of this snapshot to the given solver
+    void applySettings(const SolverSettings& settings, IKSolver& ik_solver);
+
+    realtime_tools::RealtimeBuffer<SolverSettings> m_settings_input;
+    SolverSettings    m_config_settings;  ///< Latest snapshot of the reconfigure thread
+
+    // Telemetry
+    typedef realtime_tools::RealtimePublisher<geometry_msgs::WrenchStamped> CmdPublisher;
+    boost::shared_ptr<CmdPublisher>                   m_cmd_publisher;
+    double                                            m_cmd_publish_rate;
+    ros::Time                                         m_last_cmd_publish_time;
+
+    // Adaptive iterations and instrumentation
+    enum Phase
+    {
+      CYCLE,              ///< All iterations of one control cycle
+      PD_CONTROL,         ///< The spatial PD controller
+      FORWARD_DYNAMICS,   ///< IKSolver::getJointControlCmds()
+      KINEMATICS,         ///< IKSolver::updateKinematics()
+      TRANSFORMS,         ///< displayInBaseLink() and displayInTipLink()
+      NUMBER_PHASES
+    };
+
+    struct SolverStatistics
+    {
+      SolverStatistics()
+        : iterations(0), residual(0.0), budget_overruns(0), cycle_overruns(0)
+        , condition_estimate(0.0), singularity_damping(0.0), damped_iterations(0)
+      {};
+
+      int               iterations;       ///< Iterations in the last cycle
+      double            residual;         ///< Error norm of the last iteration
+      unsigned long     budget_overruns;  ///< Cycles stopped by the time budget
+      unsigned long     cycle_overruns;   ///< Cycles that took longer than their period
+      double            condition_estimate;   ///< Of the solver's last factorization
+      double            singularity_damping;  ///< Damping added in the last iteration
+      unsigned long     damped_iterations;    ///< Iterations damped near singularities
+      LatencyHistogram  phases[NUMBER_PHASES];
+    };
+
+    //! Sample a steady clock for the instrumentation
+    ros::SteadyTime startPhase() const;
+
+    //! Add the time since start to the given phase's histogram
+    void finishPhase(Phase phase, const ros::SteadyTime& start);
+
+    ros::SteadyTime     m_cycle_start;
+    ros::Duration       m_cycle_period;
+    SolverStatistics    m_solver_statistics;    ///< Written in the control loop
+    SolverStatistics    m_shared_statistics;    ///< Read by the diagnostics timer
+    boost::mutex        m_statistics_mutex;
+
+    // Diagnostics
+    void publishDiagnostics(const ros::TimerEvent& event);
+
+    ros::Publisher      m_diagnostics_publisher;
+    ros::Timer          m_diagnostics_timer;
+    std::string         m_diagnostics_name;
+    unsigned long       m_reported_cycle_overruns;
+
+    // Hot standby
+    /**
+     * @brief Track the real joint state while this controller is inactive
+     *
+     * Runs outside the control loop and prepares a second solver, so that
+     * \ref starting only needs to swap it in and update the segment frames
+     * for the current joint state.
+     */
+    void updateStandbyState(const ros::TimerEvent& event);
+
+    boost::shared_ptr<IKSolver> m_standby_solver;
+    boost::mutex        m_standby_mutex;
+    ros::Timer          m_standby_timer;
+    double              m_standby_rate;
+    double              m_standby_max_offset; //!< Of the joints from the standby sample for a warm start
+    ros::Time           m_standby_stamp;
+    bool                m_standby_valid;
+    unsigned long       m_standby_settings_version; //!< Of the settings applied to the standby solver
+    ros::Time           m_start_time;
+    bool                m_warm_start;
+
+    // Recording
+    //! Write the recorded cycles to a file once the control loop has frozen them
+    void dumpRecords(const ros::TimerEvent& event);
+
+    bool dumpRecordsCallback(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res);
+
+    CycleRecorder       m_recorder;
+    ros::Timer          m_recorder_timer;
+    ros::ServiceServer  m_recorder_service;
+    std::string         m_recorder_directory;
+    bool                m_recorder_dump_on_overrun;
+
     // Against multi initialization in multi inheritance scenarios
     bool m_already_initialized;;
 
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    BiasEstimator.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/BiasEstimator.h>
+
+namespace cartesian_controller_base
+{
+
+BiasEstimator::BiasEstimator()
+  : m_bias(ctrl::Vector6D::Zero())
+  , m_sum(ctrl::Vector6D::Zero())
+  , m_taring_samples(50)
+  , m_taring_count(0)
+  , m_time_constant(0.0)
+  , m_force_threshold(1.0)
+  , m_torque_threshold(0.1)
+{
+}
+
+bool BiasEstimator::init(ros::NodeHandle& nh)
+{
+  nh.param("taring_samples",m_taring_samples,50);
+  nh.param("time_constant",m_time_constant,0.0);
+  nh.param("force_threshold",m_force_threshold,1.0);
+  nh.param("torque_threshold",m_torque_threshold,0.1);
+
+  if (m_taring_samples < 1 || m_time_constant < 0.0)
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << ": Need at least one taring sample and a non-negative time constant");
+    return false;
+  }
+  return true;
+}
+
+void BiasEstimator::startTaring()
+{
+  m_sum.setZero();
+  m_taring_count = m_taring_samples;
+}
+
+bool BiasEstimator::addSample(const ctrl::Vector6D& sample)
+{
+  if (m_taring_count == 0)
+  {
+    return false;
+  }
+
+  m_sum += sample;
+  if (--m_taring_count > 0)
+  {
+    return false;
+  }
+  m_bias = m_sum / m_taring_samples;
+  return true;
+}
+
+void BiasEstimator::track(const ctrl::Vector6D& residual, const ros::Duration& period)
+{
+  if (m_time_constant <= 0.0 || taring())
+  {
+    return;
+  }
+
+  // Contact, not drift
+  if (residual.head<3>().norm() > m_force_threshold ||
+      residual.tail<3>().norm() > m_torque_threshold)
+  {
+    return;
+  }
+
+  const double dt = period.toSec();
+  m_bias += dt / (m_time_constant + dt) * residual;
+}
+
+} // namespace
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    CompactStream.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/CompactStream.h>
+
+// ROS
+#include <ros/ros.h>
+
+// Other
+#include <algorithm>
+
+namespace cartesian_controller_base
+{
+
+CompactStream::CompactStream()
+  : m_frame_index(0)
+  , m_started(false)
+  , m_last_seq(0)
+  , m_dropped(0)
+{
+}
+
+bool CompactStream::init(const ros::NodeHandle& nh, const std::string& topic, const std::string& frame)
+{
+  m_topic = topic;
+  m_frame = frame;
+  m_started = false;
+  m_dropped = 0;
+
+  std::vector<std::string> frames;
+  if (!nh.getParam("compact/frames",frames))
+  {
+    m_frame_index = 0;
+    return true;
+  }
+  std::vector<std::string>::const_iterator it = std::find(frames.begin(),frames.end(),frame);
+  if (it == frames.end())
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << "/compact/frames needs to list "
+        << frame << " for " << topic);
+    return false;
+  }
+  m_frame_index = it - frames.begin();
+  return true;
+}
+
+bool CompactStream::accept(uint16_t frame, uint32_t seq)
+{
+  if (frame != m_frame_index)
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got compact message on " << m_topic
+        << " in wrong reference frame. Expected index " << m_frame_index
+        << " (" << m_frame << ") but got " << frame);
+    return false;
+  }
+
+  // Unsigned arithmetic handles the wrap-around of sequence numbers
+  const uint32_t gap = seq - m_last_seq - 1;
+  if (m_started && gap > 0 && gap < 0x80000000u)
+  {
+    m_dropped += gap;
+    ROS_WARN_STREAM_THROTTLE(3, "Lost " << gap << " compact messages on "
+        << m_topic << ", " << m_dropped << " in total");
+  }
+  m_last_seq = seq;
+  m_started = true;
+  return true;
+}
+
+unsigned long CompactStream::dropped() const
+{
+  return m_dropped;
+}
+
+KDL::Frame CompactStream::toFrame(const float* values)
+{
+  return KDL::Frame(
+      KDL::Rotation::Quaternion(values[3],values[4],values[5],values[6]),
+      KDL::Vector(values[0],values[1],values[2]));
+}
+
+KDL::Wrench CompactStream::toWrench(const float* values)
+{
+  return KDL::Wrench(
+      KDL::Vector(values[0],values[1],values[2]),
+      KDL::Vector(values[3],values[4],values[5]));
+}
+
+} // namespace
@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    CycleRecorder.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/CycleRecorder.h>
+
+// Other
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace cartesian_controller_base
+{
+
+namespace
+{
+  const char MAGIC[8] = "CCREC02";
+}
+
+CycleRecorder::CycleRecorder()
+  : m_number_joints(0)
+  , m_record_size(0)
+  , m_capacity(0)
+  , m_count(0)
+  , m_joint_efforts(false)
+  , m_dump_requested(false)
+  , m_frozen(false)
+{
+}
+
+void CycleRecorder::init(int number_joints, int capacity, const std::string& solver_type, bool joint_efforts)
+{
+  m_number_joints = number_joints;
+  m_record_size = offset(NUMBER_FIELDS,number_joints);
+  m_capacity = std::max(capacity,0);
+  m_count = 0;
+  m_solver_type = solver_type;
+  m_joint_efforts = joint_efforts;
+  m_records.assign(static_cast<size_t>(m_capacity) * m_record_size,0.0);
+  m_current.assign(m_record_size,0.0);
+  m_dump_requested = false;
+  m_frozen = false;
+}
+
+bool CycleRecorder::enabled() const
+{
+  return m_capacity > 0;
+}
+
+int CycleRecorder::size(Field field, int number_joints)
+{
+  switch (field)
+  {
+    case STAMP:
+    case PERIOD:
+    case INTERNAL_PERIOD:
+    case ITERATIONS:
+    case CYCLE_TIME:
+      return 1;
+    case TARGET_POSE:
+      return 7;
+    case WRENCH:
+    case NET_FORCE:
+      return 6;
+    case NUMBER_FIELDS:
+      return 0;
+    default:
+      return number_joints;
+  }
+}
+
+int CycleRecorder::offset(Field field, int number_joints)
+{
+  int offset = 0;
+  for (int i = 0; i < field; ++i)
+  {
+    offset += size(static_cast<Field>(i),number_joints);
+  }
+  return offset;
+}
+
+void CycleRecorder::set(Field field, const double* values)
+{
+  std::copy(values,values + size(field,m_number_joints),
+            m_current.begin() + offset(field,m_number_joints));
+}
+
+void CycleRecorder::setJointState(const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+{
+  if (!enabled())
+  {
+    return;
+  }
+  double* positions = &m_current[offset(JOINT_POSITIONS,m_number_joints)];
+  double* velocities = &m_current[offset(JOINT_VELOCITIES,m_number_joints)];
+  for (int i = 0; i < m_number_joints; ++i)
+  {
+    positions[i] = joint_handles[i].getPosition();
+    velocities[i] = joint_handles[i].getVelocity();
+  }
+}
+
+void CycleRecorder::setSolverState(const KDL::JntArray& positions, const KDL::JntArray& velocities)
+{
+  if (!enabled())
+  {
+    return;
+  }
+  set(SOLVER_POSITIONS,positions.data.data());
+  set(SOLVER_VELOCITIES,velocities.data.data());
+}
+
+void CycleRecorder::setTarget(const KDL::Frame& target)
+{
+  if (!enabled())
+  {
+    return;
+  }
+  double pose[7] = {target.p.x(), target.p.y(), target.p.z()};
+  target.M.GetQuaternion(pose[3],pose[4],pose[5],pose[6]);
+  set(TARGET_POSE,pose);
+}
+
+void CycleRecorder::setWrench(const ctrl::Vector6D& wrench)
+{
+  if (!enabled())
+  {
+    return;
+  }
+  set(WRENCH,wrench.data());
+}
+
+void CycleRecorder::setFirstStep(
+    const ros::Duration& internal_period,
+    const ctrl::Vector6D& net_force,
+    const KDL::JntArray& positions,
+    const KDL::JntArray& velocities,
+    const KDL::JntArray& efforts)
+{
+  if (!enabled())
+  {
+    return;
+  }
+  m_current[offset(INTERNAL_PERIOD,m_number_joints)] = internal_period.toSec();
+  set(NET_FORCE,net_force.data());
+  set(STEP_POSITIONS,positions.data.data());
+  set(STEP_VELOCITIES,velocities.data.data());
+  set(STEP_EFFORTS,efforts.data.data());
+}
+
+void CycleRecorder::finishCycle(
+    double stamp,
+    const ros::Duration& period,
+    int iterations,
+    double cycle_time,
+    const KDL::JntArrayVel& commands,
+    const KDL::JntArray& efforts)
+{
+  if (!enabled() || m_frozen)
+  {
+    return;
+  }
+  m_current[offset(STAMP,m_number_joints)] = stamp;
+  m_current[offset(PERIOD,m_number_joints)] = period.toSec();
+  m_current[offset(ITERATIONS,m_number_joints)] = iterations;
+  m_current[offset(CYCLE_TIME,m_number_joints)] = cycle_time;
+  set(CMD_POSITIONS,commands.q.data.data());
+  set(CMD_VELOCITIES,commands.qdot.data.data());
+  set(CMD_EFFORTS,efforts.data.data());
+
+  std::copy(m_current.begin(),m_current.end(),
+            m_records.begin() + (m_count % m_capacity) * m_record_size);
+  ++m_count;
+
+  // Keep the cycle that went wrong as the last record
+  const bool finite = commands.q.data.allFinite() && commands.qdot.data.allFinite() &&
+    efforts.data.allFinite();
+  if (m_dump_requested.exchange(false) || !finite)
+  {
+    m_frozen = true;
+  }
+}
+
+void CycleRecorder::requestDump()
+{
+  m_dump_requested = true;
+}
+
+bool CycleRecorder::frozen() const
+{
+  return m_frozen;
+}
+
+bool CycleRecorder::dump(const std::string& filename)
+{
+  if (!m_frozen)
+  {
+    return false;
+  }
+
+  const unsigned long number_records = std::min<unsigned long>(m_count,m_capacity);
+  const size_t record_bytes = m_record_size * sizeof(double);
+  const size_t file_size = sizeof(FileHeader) + number_records * record_bytes;
+
+  bool success = false;
+  const int fd = ::open(filename.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+  if (fd >= 0 && ::ftruncate(fd,file_size) == 0)
+  {
+    void* mapped = ::mmap(NULL,file_size,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+    if (mapped != MAP_FAILED)
+    {
+      FileHeader header;
+      std::memset(&header,0,sizeof(header));
+      std::memcpy(header.magic,MAGIC,sizeof(MAGIC));
+      header.number_joints = m_number_joints;
+      header.record_size = m_record_size;
+      header.number_records = number_records;
+      std::strncpy(header.solver_type,m_solver_type.c_str(),sizeof(header.solver_type) - 1);
+      header.joint_efforts = m_joint_efforts;
+      std::memcpy(mapped,&header,sizeof(header));
+
+      // Unroll the ring, oldest record first
+      char* data = static_cast<char*>(mapped) + sizeof(header);
+      const unsigned long first = m_count - number_records;
+      for (unsigned long i = 0; i < number_records; ++i)
+      {
+        std::memcpy(data + i * record_bytes,
+                    &m_records[((first + i) % m_capacity) * m_record_size],
+                    record_bytes);
+      }
+      success = ::msync(mapped,file_size,MS_SYNC) == 0;
+      ::munmap(mapped,file_size);
+    }
+  }
+  if (fd >= 0)
+  {
+    ::close(fd);
+  }
+
+  // Start anew
+  m_count = 0;
+  m_frozen = false;
+  return success;
+}
+
+bool CycleRecorder::load(const std::string& filename, FileHeader& header, std::vector<double>& records)
+{
+  std::ifstream file(filename.c_str(),std::ios::binary);
+  if (!file.read(reinterpret_cast<char*>(&header),sizeof(header)) ||
+      std::memcmp(header.magic,MAGIC,sizeof(MAGIC)) != 0 ||
+      header.record_size != static_cast<uint32_t>(offset(NUMBER_FIELDS,header.number_joints)))
+  {
+    return false;
+  }
+  header.solver_type[sizeof(header.solver_type) - 1] = '\0';
+
+  records.resize(header.number_records * header.record_size);
+  return records.empty() ||
+    file.read(reinterpret_cast<char*>(&records[0]),records.size() * sizeof(double));
+}
+
+} // namespace
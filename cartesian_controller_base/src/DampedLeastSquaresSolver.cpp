@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    DampedLeastSquaresSolver.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// this package
+#include <cartesian_controller_base/DampedLeastSquaresSolver.h>
+
+// other
+#include <algorithm>
+
+namespace cartesian_controller_base{
+
+  DampedLeastSquaresSolver::DampedLeastSquaresSolver()
+    : m_damping(0.05)
+  {
+  }
+
+  DampedLeastSquaresSolver::~DampedLeastSquaresSolver(){}
+
+  void DampedLeastSquaresSolver::getJointControlCmds(
+        ros::Duration period,
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& positions,
+        KDL::JntArray& velocities)
+  {
+    // The Jacobian is usually up to date from the last call of
+    // updateKinematics(). Recompute it otherwise.
+    if (!m_chain_quantities_valid)
+    {
+      computeChainQuantities();
+    }
+
+    const double dt = period.toSec();
+    computeJointVelocities(net_force,dt,m_current_velocities);
+    m_current_positions.data = m_last_positions.data + m_current_velocities.data * dt;
+
+    // Make sure positions stay in allowed margins.
+    // Velocities must match the clamped positions for velocity control.
+    if (clampPositions() && dt > 0.0)
+    {
+      m_current_velocities.data = (m_current_positions.data - m_last_positions.data) / dt;
+    }
+    m_chain_quantities_valid = false;
+
+    // Apply results
+    positions.data = m_current_positions.data;
+    velocities.data = m_current_velocities.data;
+  }
+
+  void DampedLeastSquaresSolver::setDamping(double damping)
+  {
+    m_damping = std::max(damping,1.0e-6);
+  }
+
+  void DampedLeastSquaresSolver::computeJointVelocities(
+      const ctrl::Vector6D& cartesian_velocity,
+      double dt,
+      KDL::JntArray& velocities)
+  {
+    // \f$ \dot{q} = J^T (J J^T + \lambda^2 I)^{-1} \dot{x} \f$
+    // Only the 6x6 system gets factorized, independent of the joint count.
+    factorizeJacobian();
+    m_cartesian_buffer = m_decomposition.solve(cartesian_velocity);
+    velocities.data.noalias() = m_jnt_jacobian.data.transpose() * m_cartesian_buffer;
+  }
+
+  void DampedLeastSquaresSolver::factorizeJacobian()
+  {
+    m_jacobian_gram.noalias() = m_jnt_jacobian.data * m_jnt_jacobian.data.transpose();
+    m_jacobian_gram.diagonal().array() += m_damping * m_damping;
+    m_decomposition.compute(m_jacobian_gram);
+
+    // Refactorize with additional damping only near singularities
+    const double damping = updateSingularityDamping(
+        m_decomposition.vectorD().cwiseAbs().maxCoeff() /
+        m_decomposition.vectorD().cwiseAbs().minCoeff());
+    if (damping > 0.0)
+    {
+      m_jacobian_gram.diagonal().array() += damping;
+      m_decomposition.compute(m_jacobian_gram);
+    }
+  }
+
+} // namespace
@@ -43,12 +43,12 @@
 // other
 #include <map>
 #include <sstream>
+#include <algorithm>
 #include <boost/algorithm/clamp.hpp>
 #include <eigen_conversions/eigen_kdl.h>
 
 // KDL
 #include <kdl/jntarrayvel.hpp>
-#include <kdl/framevel.hpp>
 
 // DEBUG
 
@@ -56,83 +56,117 @@
 namespace cartesian_controller_base{
 
   ForwardDynamicsSolver::ForwardDynamicsSolver()
+    : m_refactorization_threshold(0.0)
+    , m_factorization_valid(false)
+    , m_integrator(ZERO_MOTION)
+    , m_null_space_damping(0.0)
   {
   }
 
   ForwardDynamicsSolver::~ForwardDynamicsSolver(){}
 
-  trajectory_msgs::JointTrajectoryPoint ForwardDynamicsSolver::getJointControlCmds(
+  void ForwardDynamicsSolver::getJointControlCmds(
         ros::Duration period,
-        const ctrl::Vector6D& net_force)
+        const ctrl::Vector6D& net_force,
+        KDL::JntArray& positions,
+        KDL::JntArray& velocities)
   {
 
-    // Compute joint space inertia matrix
-    m_jnt_space_inertia_solver->JntToMass(m_current_positions,m_jnt_space_inertia);
-
-    // Compute joint jacobian
-    m_jnt_jacobian_solver->JntToJac(m_current_positions,m_jnt_jacobian);
+    // Jacobian and inertia are usually up to date from the last call of
+    // updateKinematics(). Recompute them otherwise.
+    if (!m_chain_quantities_valid)
+    {
+      computeChainQuantities();
+    }
 
     // Compute joint accelerations according to: \f$ \ddot{q} = H^{-1} ( J^T f) \f$
-    m_current_accelerations.data = m_jnt_space_inertia.data.inverse() * m_jnt_jacobian.data.transpose() * net_force;
+    m_kernel->computeAccelerations(net_force,m_current_accelerations);
 
-    // Integrate once, starting with zero motion
-    m_current_velocities.data = 0.5 * m_current_accelerations.data * period.toSec();
-
-    // Integrate twice, starting with zero motion
-    m_current_positions.data = m_last_positions.data + 0.5 * m_current_velocities.data * period.toSec();
+    // Don't let carried-over velocities drift in the null space
+    if (m_integrator != ZERO_MOTION && m_null_space_damping > 0.0)
+    {
+      m_kernel->dampNullSpace(m_null_space_damping,m_current_velocities);
+    }
 
-    // Make sure positions stay in allowed margins
-    for (int i = 0; i < m_number_joints; ++i)
+    const double dt = period.toSec();
+    switch (m_integrator)
     {
-      m_current_positions(i) = boost::algorithm::clamp(
-          m_current_positions(i),m_lower_pos_limits(i),m_upper_pos_limits(i));
+      case SEMI_IMPLICIT_EULER:
+        m_current_velocities.data += m_current_accelerations.data * dt;
+        m_current_positions.data = m_last_positions.data + m_current_velocities.data * dt;
+        break;
+
+      case CONSTANT_ACCELERATION:
+        m_current_positions.data = m_last_positions.data
+          + (m_current_velocities.data + 0.5 * m_current_accelerations.data * dt) * dt;
+        m_current_velocities.data += m_current_accelerations.data * dt;
+        break;
+
+      default:
+        // Integrate once, starting with zero motion
+        m_current_velocities.data = 0.5 * m_current_accelerations.data * dt;
+
+        // Integrate twice, starting with zero motion
+        m_current_positions.data = m_last_positions.data + 0.5 * m_current_velocities.data * dt;
+        break;
     }
 
-    // Apply results
-    trajectory_msgs::JointTrajectoryPoint control_cmd;
+    // Make sure positions stay in allowed margins.
+    // Joints that hit their limits lose their carried-over velocity.
     for (int i = 0; i < m_number_joints; ++i)
     {
-      control_cmd.positions.push_back(m_current_positions(i));
-      control_cmd.velocities.push_back(m_current_velocities(i));
-
-      // Accelerations should be left empty. Those values will be interpreted
-      // by most hardware joint drivers as max. tolerated values. As a
-      // consequence, the robot will move very slowly.
+      const double unclamped = m_current_positions(i);
+      m_current_positions(i) = boost::algorithm::clamp(
+          unclamped,m_lower_pos_limits(i),m_upper_pos_limits(i));
+      if (m_current_positions(i) != unclamped && m_integrator != ZERO_MOTION)
+      {
+        m_current_velocities(i) = 0.0;
+      }
     }
-    control_cmd.time_from_start = period; // valid for this duration
+    m_chain_quantities_valid = false;
 
-    return control_cmd;
+    // Apply results.
+    // Eigen only reallocates on size mismatch, which is a one-time event for
+    // buffers that haven't been prepared by the caller.
+    positions.data = m_current_positions.data;
+    velocities.data = m_current_velocities.data;
   }
 
 
-  const KDL::Frame& ForwardDynamicsSolver::getEndEffectorPose() const
+  void ForwardDynamicsSolver::setIntegrator(Integrator integrator)
   {
-    return m_end_effector_pose;
+    m_integrator = integrator;
   }
 
-  const ctrl::Vector6D& ForwardDynamicsSolver::getEndEffectorVel() const
+  void ForwardDynamicsSolver::setNullSpaceDamping(double damping)
   {
-    return m_end_effector_vel;
+    m_null_space_damping = boost::algorithm::clamp(damping,0.0,1.0);
   }
 
-  const KDL::JntArray& ForwardDynamicsSolver::getPositions() const
+  void ForwardDynamicsSolver::swapState(IKSolver& other)
   {
-    return m_current_positions;
-  }
+    IKSolver::swapState(other);
 
+    ForwardDynamicsSolver& solver = static_cast<ForwardDynamicsSolver&>(other);
+    m_jnt_space_inertia.data.swap(solver.m_jnt_space_inertia.data);
+    m_kernel.swap(solver.m_kernel);
+    m_factorized_positions.data.swap(solver.m_factorized_positions.data);
+    std::swap(m_factorization_valid,solver.m_factorization_valid);
+  }
 
-  bool ForwardDynamicsSolver::setStartState(
-      const std::vector<hardware_interface::JointHandle>& joint_handles)
+  void ForwardDynamicsSolver::resumeState(
+      const std::vector<hardware_interface::JointStateHandle>& joint_handles)
   {
-    // Copy into internal buffers.
-    for (int i = 0; i < joint_handles.size(); ++i)
+    IKSolver::resumeState(joint_handles);
+    if (m_factorization_valid)
     {
-      m_current_positions(i)      = joint_handles[i].getPosition();
-      m_current_velocities(i)     = joint_handles[i].getVelocity();
-      m_current_accelerations(i)  = 0.0;
-      m_last_positions(i)         = m_current_positions(i);
+      m_factorized_positions.data = m_current_positions.data;
     }
-    return true;
+  }
+
+  void ForwardDynamicsSolver::setRefactorizationThreshold(double threshold)
+  {
+    m_refactorization_threshold = threshold;
   }
 
 
@@ -141,37 +175,61 @@ namespace cartesian_controller_base{
       const KDL::JntArray& upper_pos_limits,
       const KDL::JntArray& lower_pos_limits)
   {
+    // Common buffers and kinematics
+    IKSolver::init(chain,upper_pos_limits,lower_pos_limits);
+
     if (!buildGenericModel(chain))
     {
       ROS_ERROR("ForwardDynamicsSolver: Something went wrong in setting up the internal model.");
       return false;
     }
 
-    // Initialize
-    m_number_joints              = m_chain.getNrOfJoints();
-    m_current_positions.data     = ctrl::VectorND::Zero(m_number_joints);
-    m_current_velocities.data    = ctrl::VectorND::Zero(m_number_joints);
-    m_current_accelerations.data = ctrl::VectorND::Zero(m_number_joints);
-    m_last_positions.data        = ctrl::VectorND::Zero(m_number_joints);
-    m_upper_pos_limits           = upper_pos_limits;
-    m_lower_pos_limits           = lower_pos_limits;
-
-    // Forward kinematics
-    m_fk_pos_solver.reset(new KDL::ChainFkSolverPos_recursive(m_chain));
-    m_fk_vel_solver.reset(new KDL::ChainFkSolverVel_recursive(m_chain));
-
     // Forward dynamics
-    m_jnt_jacobian_solver.reset(new KDL::ChainJntToJacSolver(m_chain));
-    m_jnt_space_inertia_solver.reset(new KDL::ChainDynParam(m_chain,KDL::Vector::Zero()));
-    m_jnt_jacobian.resize(m_number_joints);
     m_jnt_space_inertia.resize(m_number_joints);
 
+    // Preallocate the linear algebra.
+    // Common joint counts get fixed-size types.
+    m_kernel.reset(ForwardDynamicsKernelBase::create(m_number_joints));
+    m_factorized_positions.data  = ctrl::VectorND::Zero(m_number_joints);
+    m_factorization_valid        = false;
+
     ROS_INFO("Forward dynamics solver initialized");
     ROS_INFO("Forward dynamics solver has control over %i joints", m_number_joints);
 
     return true;
   }
 
+  void ForwardDynamicsSolver::computeChainQuantities()
+  {
+    // Only recompute the joint space inertia matrix if the joint configuration
+    // has noticeably changed since the last factorization.
+    const bool refactorize = !m_factorization_valid ||
+      (m_current_positions.data - m_factorized_positions.data).lpNorm<Eigen::Infinity>()
+      > m_refactorization_threshold;
+
+    const bool jacobian_updated = computeKinematics(refactorize ? &m_jnt_space_inertia : NULL);
+
+    // Hand over to the solver kernel
+    if (jacobian_updated)
+    {
+      m_kernel->setJacobian(m_jnt_jacobian);
+    }
+    if (refactorize)
+    {
+      m_kernel->setJntSpaceInertia(m_jnt_space_inertia);
+
+      // Refactorize with damping only near singularities
+      const double damping = updateSingularityDamping(m_kernel->getConditionEstimate());
+      if (damping > 0.0)
+      {
+        m_jnt_space_inertia.data.diagonal().array() += damping;
+        m_kernel->setJntSpaceInertia(m_jnt_space_inertia);
+      }
+      m_factorized_positions.data = m_current_positions.data;
+      m_factorization_valid = true;
+    }
+  }
+
   bool ForwardDynamicsSolver::buildGenericModel(const KDL::Chain& input_chain)
   {
     m_chain = input_chain;
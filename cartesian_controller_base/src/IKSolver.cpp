@@ -0,0 +1,479 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    IKSolver.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// this package
+#include <cartesian_controller_base/IKSolver.h>
+#include <cartesian_controller_base/ForwardDynamicsSolver.h>
+#include <cartesian_controller_base/DampedLeastSquaresSolver.h>
+#include <cartesian_controller_base/QPSolver.h>
+
+// other
+#include <algorithm>
+#include <limits>
+#include <boost/algorithm/clamp.hpp>
+
+namespace cartesian_controller_base{
+
+  IKSolver::IKSolver()
+    : m_number_joints(0)
+    , m_motion_limits(false)
+    , m_singularity_threshold(0.0)
+    , m_max_singularity_damping(0.0)
+    , m_condition_estimate(0.0)
+    , m_singularity_damping(0.0)
+    , m_chain_quantities_valid(false)
+    , m_jacobian_threshold(0.0)
+    , m_jacobian_valid(false)
+  {
+  }
+
+  IKSolver::~IKSolver(){}
+
+  IKSolver* IKSolver::create(const std::string& type)
+  {
+    if (type == "forward_dynamics")
+    {
+      return new ForwardDynamicsSolver();
+    }
+    if (type == "damped_least_squares")
+    {
+      return new DampedLeastSquaresSolver();
+    }
+    if (type == "qp")
+    {
+      return new QPSolver();
+    }
+    return NULL;
+  }
+
+  trajectory_msgs::JointTrajectoryPoint IKSolver::getJointControlCmds(
+        ros::Duration period,
+        const ctrl::Vector6D& net_force)
+  {
+    KDL::JntArray positions(m_number_joints);
+    KDL::JntArray velocities(m_number_joints);
+    getJointControlCmds(period,net_force,positions,velocities);
+
+    // Apply results
+    trajectory_msgs::JointTrajectoryPoint control_cmd;
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      control_cmd.positions.push_back(positions(i));
+      control_cmd.velocities.push_back(velocities(i));
+
+      // Accelerations should be left empty. Those values will be interpreted
+      // by most hardware joint drivers as max. tolerated values. As a
+      // consequence, the robot will move very slowly.
+    }
+    control_cmd.time_from_start = period; // valid for this duration
+
+    return control_cmd;
+  }
+
+  const KDL::Frame& IKSolver::getEndEffectorPose() const
+  {
+    return m_end_effector_pose;
+  }
+
+  const ctrl::Vector6D& IKSolver::getEndEffectorVel() const
+  {
+    return m_end_effector_vel;
+  }
+
+  const std::vector<KDL::Frame>& IKSolver::getSegmentFrames()
+  {
+    if (!m_chain_quantities_valid)
+    {
+      computeChainQuantities();
+    }
+    return m_segment_frames;
+  }
+
+  const KDL::Jacobian& IKSolver::getJacobian()
+  {
+    if (!m_chain_quantities_valid)
+    {
+      computeChainQuantities();
+    }
+    return m_jnt_jacobian;
+  }
+
+  const KDL::JntArray& IKSolver::getPositions() const
+  {
+    return m_current_positions;
+  }
+
+  const KDL::JntArray& IKSolver::getVelocities() const
+  {
+    return m_current_velocities;
+  }
+
+  bool IKSolver::setStartState(
+      const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+  {
+    // Copy into internal buffers.
+    for (int i = 0; i < joint_handles.size(); ++i)
+    {
+      m_current_positions(i)      = joint_handles[i].getPosition();
+      m_current_velocities(i)     = joint_handles[i].getVelocity();
+      m_current_accelerations(i)  = 0.0;
+      m_last_positions(i)         = m_current_positions(i);
+      m_last_velocities(i)        = m_current_velocities(i);
+    }
+
+    // Keep cached quantities such as the Jacobian. They get updated if the
+    // new state is too far away from where they were computed.
+    m_chain_quantities_valid = false;
+    return true;
+  }
+
+  void IKSolver::swapState(IKSolver& other)
+  {
+    // Eigen swaps dynamic-size buffers by their pointers
+    m_current_positions.data.swap(other.m_current_positions.data);
+    m_current_velocities.data.swap(other.m_current_velocities.data);
+    m_current_accelerations.data.swap(other.m_current_accelerations.data);
+    m_last_positions.data.swap(other.m_last_positions.data);
+    m_last_velocities.data.swap(other.m_last_velocities.data);
+
+    m_segment_frames.swap(other.m_segment_frames);
+    std::swap(m_end_effector_pose,other.m_end_effector_pose);
+    m_end_effector_vel.swap(other.m_end_effector_vel);
+    std::swap(m_chain_quantities_valid,other.m_chain_quantities_valid);
+
+    m_jnt_jacobian.data.swap(other.m_jnt_jacobian.data);
+    m_jacobian_positions.data.swap(other.m_jacobian_positions.data);
+    std::swap(m_jacobian_valid,other.m_jacobian_valid);
+
+    std::swap(m_condition_estimate,other.m_condition_estimate);
+    std::swap(m_singularity_damping,other.m_singularity_damping);
+  }
+
+  void IKSolver::resumeState(
+      const std::vector<hardware_interface::JointStateHandle>& joint_handles)
+  {
+    setStartState(joint_handles);
+    if (m_jacobian_valid)
+    {
+      m_jacobian_positions.data = m_current_positions.data;
+    }
+    computeKinematics();
+  }
+
+  void IKSolver::setJacobianThreshold(double threshold)
+  {
+    m_jacobian_threshold = threshold;
+  }
+
+  void IKSolver::setMotionLimits(
+      const KDL::JntArray& max_velocities,
+      const KDL::JntArray& max_accelerations)
+  {
+    m_max_velocities = max_velocities;
+    m_max_accelerations = max_accelerations;
+    m_motion_limits =
+      (m_max_velocities.data.array() < std::numeric_limits<double>::infinity()).any() ||
+      (m_max_accelerations.data.array() < std::numeric_limits<double>::infinity()).any();
+  }
+
+  bool IKSolver::limitPositionCommands(
+      const KDL::JntArray& last_positions,
+      const KDL::JntArray& last_velocities,
+      const ros::Duration& period,
+      KDL::JntArray& positions,
+      KDL::JntArray& velocities) const
+  {
+    // Without time to move, hold the last commands
+    const double dt = period.toSec();
+    if (dt <= 0.0)
+    {
+      positions.data = last_positions.data;
+      velocities.data.setZero();
+      return true;
+    }
+
+    velocities.data = (positions.data - last_positions.data) / dt;
+    if (!m_motion_limits || !limitVelocities(last_velocities,dt,velocities))
+    {
+      return false;
+    }
+
+    // Position limits take precedence
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      positions(i) = boost::algorithm::clamp(
+          last_positions(i) + velocities(i) * dt,
+          std::min(m_lower_pos_limits(i),last_positions(i)),
+          std::max(m_upper_pos_limits(i),last_positions(i)));
+      velocities(i) = (positions(i) - last_positions(i)) / dt;
+    }
+    return true;
+  }
+
+  bool IKSolver::limitVelocityCommands(
+      const KDL::JntArray& last_velocities,
+      const ros::Duration& period,
+      KDL::JntArray& velocities) const
+  {
+    if (!m_motion_limits)
+    {
+      return false;
+    }
+    return limitVelocities(last_velocities,std::max(period.toSec(),0.0),velocities);
+  }
+
+  void IKSolver::setPositions(const KDL::JntArray& positions)
+  {
+    m_current_positions.data = positions.data;
+    m_current_velocities.data.setZero();
+    m_current_accelerations.data.setZero();
+    m_last_positions = m_current_positions;
+    m_last_velocities = m_current_velocities;
+    computeChainQuantities();
+  }
+
+  void IKSolver::setSingularityDamping(double threshold, double damping)
+  {
+    m_singularity_threshold = std::max(threshold,0.0);
+    m_max_singularity_damping = std::max(damping,0.0);
+  }
+
+  double IKSolver::getConditionEstimate() const
+  {
+    return m_condition_estimate;
+  }
+
+  double IKSolver::getSingularityDamping() const
+  {
+    return m_singularity_damping;
+  }
+
+  double IKSolver::updateSingularityDamping(double estimate)
+  {
+    m_condition_estimate = estimate;
+    m_singularity_damping = 0.0;
+    if (m_singularity_threshold > 0.0 && estimate > m_singularity_threshold)
+    {
+      // Rises smoothly from zero at the threshold
+      m_singularity_damping =
+        m_max_singularity_damping * (1.0 - m_singularity_threshold / estimate);
+    }
+    return m_singularity_damping;
+  }
+
+  bool IKSolver::init(
+      const KDL::Chain& chain,
+      const KDL::JntArray& upper_pos_limits,
+      const KDL::JntArray& lower_pos_limits)
+  {
+    m_chain = chain;
+
+    // Initialize
+    m_number_joints              = m_chain.getNrOfJoints();
+    m_current_positions.data     = ctrl::VectorND::Zero(m_number_joints);
+    m_current_velocities.data    = ctrl::VectorND::Zero(m_number_joints);
+    m_current_accelerations.data = ctrl::VectorND::Zero(m_number_joints);
+    m_last_positions.data        = ctrl::VectorND::Zero(m_number_joints);
+    m_last_velocities.data       = ctrl::VectorND::Zero(m_number_joints);
+    m_upper_pos_limits           = upper_pos_limits;
+    m_lower_pos_limits           = lower_pos_limits;
+
+    // No velocity and acceleration limits until set
+    m_max_velocities.data        = ctrl::VectorND::Constant(
+        m_number_joints,std::numeric_limits<double>::infinity());
+    m_max_accelerations.data     = m_max_velocities.data;
+    m_motion_limits              = false;
+    m_condition_estimate         = 0.0;
+    m_singularity_damping        = 0.0;
+
+    // Forward kinematics
+    m_segment_frames.resize(m_chain.getNrOfSegments());
+    m_end_effector_vel = ctrl::Vector6D::Zero();
+    m_chain_quantities_valid = false;
+
+    // Jacobian
+    m_jnt_jacobian.resize(m_number_joints);
+    m_jacobian_positions.data    = ctrl::VectorND::Zero(m_number_joints);
+    m_jacobian_valid             = false;
+
+    return true;
+  }
+
+  void IKSolver::computeChainQuantities()
+  {
+    computeKinematics();
+  }
+
+  bool IKSolver::computeKinematics(KDL::JntSpaceInertiaMatrix* inertia)
+  {
+    // The inertia is built from the Jacobian's columns during the same pass
+    const bool update_jacobian = inertia || !m_jacobian_valid ||
+      (m_current_positions.data - m_jacobian_positions.data).lpNorm<Eigen::Infinity>()
+      > m_jacobian_threshold;
+
+    if (inertia)
+    {
+      inertia->data.setZero();
+    }
+    if (update_jacobian)
+    {
+      m_jnt_jacobian.data.setZero();
+    }
+
+    KDL::Frame parent_frame = KDL::Frame::Identity();
+    int k = 0; // Index of the current joint
+    for (size_t s = 0; s < m_chain.segments.size(); ++s)
+    {
+      const KDL::Segment& segment = m_chain.segments[s];
+      const bool is_moving = segment.getJoint().getType() != KDL::Joint::None;
+      const double q = is_moving ? m_current_positions(k) : 0.0;
+
+      // Segment tip frame w. r. t. base
+      m_segment_frames[s] = parent_frame * segment.pose(q);
+
+      // Shift all Jacobian columns so far to this segment's tip and add the
+      // unit twist of this segment's joint. Everything is expressed in the
+      // base frame. Same as KDL::ChainJntToJacSolver.
+      if (update_jacobian)
+      {
+        m_jnt_jacobian.changeRefPoint(m_segment_frames[s].p - parent_frame.p);
+        if (is_moving)
+        {
+          m_jnt_jacobian.setColumn(k,parent_frame.M * segment.twist(q,1.0));
+        }
+      }
+      if (is_moving)
+      {
+        ++k;
+      }
+
+      // Each segment's inertia contributes with \f$ J_s^T I_s J_s \f$, where
+      // \f$ J_s \f$ are the first k columns, referenced at this segment.
+      if (inertia)
+      {
+        const KDL::RigidBodyInertia segment_inertia = m_segment_frames[s].M * segment.getInertia();
+        for (int j = 0; j < k; ++j)
+        {
+          const KDL::Wrench momentum = segment_inertia * m_jnt_jacobian.getColumn(j);
+          for (int i = 0; i <= j; ++i)
+          {
+            (*inertia)(i,j) += KDL::dot(m_jnt_jacobian.getColumn(i),momentum);
+            (*inertia)(j,i) = (*inertia)(i,j);
+          }
+        }
+      }
+
+      parent_frame = m_segment_frames[s];
+    }
+
+    // End effector pose and velocity
+    m_end_effector_pose = parent_frame;
+    m_end_effector_vel.noalias() = m_jnt_jacobian.data * m_current_velocities.data;
+
+    if (update_jacobian)
+    {
+      m_jacobian_positions.data = m_current_positions.data;
+      m_jacobian_valid = true;
+    }
+    m_chain_quantities_valid = true;
+    return update_jacobian;
+  }
+
+  bool IKSolver::clampPositions()
+  {
+    bool clamped = false;
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      const double unclamped = m_current_positions(i);
+      m_current_positions(i) = boost::algorithm::clamp(
+          unclamped,m_lower_pos_limits(i),m_upper_pos_limits(i));
+      clamped = clamped || m_current_positions(i) != unclamped;
+    }
+    return clamped;
+  }
+
+  bool IKSolver::limitVelocities(
+      const KDL::JntArray& last_velocities,
+      double dt,
+      KDL::JntArray& velocities) const
+  {
+    // Velocity limits bound the common scale from above
+    double upper = (m_max_velocities.data.array() / velocities.data.array().abs()).minCoeff();
+
+    // Acceleration limits bound the common scale to an interval around the
+    // last velocity. Joints without motion cannot change this by scaling.
+    double lower = 0.0;
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      const double velocity = velocities(i);
+      const double reach = m_max_accelerations(i) * dt;
+      if (velocity == 0.0 || reach == std::numeric_limits<double>::infinity())
+      {
+        continue;
+      }
+      const double a = (last_velocities(i) - reach) / velocity;
+      const double b = (last_velocities(i) + reach) / velocity;
+      lower = std::max(lower,std::min(a,b));
+      upper = std::min(upper,std::max(a,b));
+    }
+
+    if (lower <= upper)
+    {
+      const double scale = boost::algorithm::clamp(1.0,lower,upper);
+      if (scale == 1.0)
+      {
+        return false;
+      }
+      velocities.data *= scale;
+      return true;
+    }
+
+    // No common scale. Limit each joint and give up on the direction.
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      const double reach = m_max_accelerations(i) * dt;
+      velocities(i) = boost::algorithm::clamp(
+          velocities(i),last_velocities(i) - reach,last_velocities(i) + reach);
+      velocities(i) = boost::algorithm::clamp(
+          velocities(i),-m_max_velocities(i),m_max_velocities(i));
+    }
+    return true;
+  }
+
+} // namespace
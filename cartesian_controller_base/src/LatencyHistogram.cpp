@@ -28,74 +28,84 @@
 // POSSIBILITY OF SUCH DAMAGE.
 ////////////////////////////////////////////////////////////////////////////////
 
-
 //-----------------------------------------------------------------------------
-/*!\file    PDController.cpp
+/*!\file    LatencyHistogram.cpp
  *
- * \author  Stefan Scherzinger <scherzin@fzi.de>
- * \date    2019/10/16
+ * \author  agent <agent@local>
+ * \date    2026/10/14
  *
  */
 //-----------------------------------------------------------------------------
 
-#include <cartesian_controller_base/PDController.h>
+// Project
+#include <cartesian_controller_base/LatencyHistogram.h>
 
 namespace cartesian_controller_base
 {
 
-PDController::PDController()
-  : m_last_p_error(0.0)
+LatencyHistogram::LatencyHistogram()
 {
+  reset();
 }
 
-PDController::PDController(const PDController& other)
-  : m_last_p_error(other.m_last_p_error)
-  , m_dyn_conf_server(other.m_dyn_conf_server)
+void LatencyHistogram::add(const ros::WallDuration& latency)
 {
-  // Copy constructor would bind non-const ref
-  // to const, so use copy assignment operator.
-  m_gains = other.m_gains;
+  const double sample = latency.toSec();
+
+  // Find the first bucket whose upper bound is not exceeded
+  int i = 0;
+  while (i < NUMBER_BUCKETS - 1 && sample > bucketUpperBound(i))
+  {
+    ++i;
+  }
+  m_buckets[i]++;
+
+  m_count++;
+  m_sum += sample;
+  if (sample > m_max)
+  {
+    m_max = sample;
+  }
 }
 
-PDController::~PDController()
+void LatencyHistogram::reset()
 {
+  for (int i = 0; i < NUMBER_BUCKETS; ++i)
+  {
+    m_buckets[i] = 0;
+  }
+  m_count = 0;
+  m_sum = 0.0;
+  m_max = 0.0;
 }
 
-
-void PDController::init(const std::string& name_space)
+unsigned long LatencyHistogram::count() const
 {
-  // Connect dynamic reconfigure and overwrite the default values with values
-  // on the parameter server. This is done automatically if parameters with
-  // the according names exist.
-  m_callback_type = boost::bind(
-      &PDController::dynamicReconfigureCallback, this, _1, _2);
-
-  m_dyn_conf_server.reset(
-      new dynamic_reconfigure::Server<PDGainsConfig>(
-        ros::NodeHandle(name_space)));
-  m_dyn_conf_server->setCallback(m_callback_type);
-
+  return m_count;
 }
 
-
-double PDController::operator()(const double& error, const ros::Duration& period)
+double LatencyHistogram::mean() const
 {
-  if (period == ros::Duration(0.0))
-  {
-    return 0.0;
-  }
+  return m_count > 0 ? m_sum / m_count : 0.0;
+}
 
-  PDGains gains(*m_gains.readFromRT());
-  double result = gains.m_p * error + gains.m_d * (error - m_last_p_error) / period.toSec();
-//std::cout<<"P:"<<gains.m_p<<std::endl;
-//std::cout<<"D:"<<gains.m_d<<std::endl;
-  m_last_p_error = error;
-  return result;
+double LatencyHistogram::max() const
+{
+  return m_max;
 }
 
-void PDController::dynamicReconfigureCallback(PDGainsConfig& config, uint32_t level)
+unsigned long LatencyHistogram::bucket(int i) const
 {
-  m_gains.writeFromNonRT(PDGains(config.p, config.d));
+  return m_buckets[i];
 }
 
+double LatencyHistogram::bucketUpperBound(int i)
+{
+  if (i >= NUMBER_BUCKETS - 1)
+  {
+    return -1.0;
+  }
+  return 1.0e-6 * (1 << i);
 }
+
+} // namespace
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    PoseMailbox.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/PoseMailbox.h>
+
+namespace cartesian_controller_base
+{
+
+std::map<std::string, PoseMailbox::Ptr> PoseMailbox::s_mailboxes;
+boost::mutex PoseMailbox::s_mutex;
+
+PoseMailbox::Ptr PoseMailbox::get(const std::string& topic, const std::string& frame_id)
+{
+  boost::mutex::scoped_lock lock(s_mutex);
+  Ptr& mailbox = s_mailboxes[topic + " " + frame_id];
+  if (!mailbox)
+  {
+    mailbox.reset(new PoseMailbox());
+  }
+  return mailbox;
+}
+
+void PoseMailbox::write(const KDL::Frame& frame, const ros::Time& stamp)
+{
+  Sample sample;
+  sample.frame = frame;
+  sample.stamp = stamp;
+  m_samples.write(sample);
+}
+
+bool PoseMailbox::read(KDL::Frame& frame, ros::Time& stamp, unsigned long& sequence) const
+{
+  Sample sample;
+  Sample scratch;
+  if (!m_samples.read(sample,sequence,scratch))
+  {
+    return false;
+  }
+  frame = sample.frame;
+  stamp = sample.stamp;
+  return true;
+}
+
+unsigned long PoseMailbox::sequence() const
+{
+  return m_samples.sequence();
+}
+
+bool PoseMailbox::isActive(const ros::Time& now, const ros::Duration& timeout) const
+{
+  KDL::Frame frame;
+  ros::Time stamp;
+  unsigned long sequence = 0;
+  if (!read(frame,stamp,sequence))
+  {
+    return false;
+  }
+  return now - stamp < timeout;
+}
+
+} // namespace
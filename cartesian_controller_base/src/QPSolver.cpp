@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    QPSolver.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// this package
+#include <cartesian_controller_base/QPSolver.h>
+
+// other
+#include <algorithm>
+#include <limits>
+
+namespace cartesian_controller_base{
+
+  QPSolver::QPSolver()
+  {
+  }
+
+  QPSolver::~QPSolver(){}
+
+  bool QPSolver::init(
+      const KDL::Chain& chain,
+      const KDL::JntArray& upper_pos_limits,
+      const KDL::JntArray& lower_pos_limits)
+  {
+    if (!DampedLeastSquaresSolver::init(chain,upper_pos_limits,lower_pos_limits))
+    {
+      return false;
+    }
+
+    // Preallocate the active set method
+    m_hessian           = ctrl::MatrixND::Zero(m_number_joints,m_number_joints);
+    m_gradient          = ctrl::VectorND::Zero(m_number_joints);
+    m_lower             = ctrl::VectorND::Zero(m_number_joints);
+    m_upper             = ctrl::VectorND::Zero(m_number_joints);
+    m_reduced_hessian   = ctrl::MatrixND::Zero(m_number_joints,m_number_joints);
+    m_reduced_gradient  = ctrl::VectorND::Zero(m_number_joints);
+    m_candidate         = ctrl::VectorND::Zero(m_number_joints);
+    m_residual          = ctrl::VectorND::Zero(m_number_joints);
+    m_decomposition     = Eigen::LDLT<ctrl::MatrixND>(m_number_joints);
+    m_bounds.resize(m_number_joints);
+    return true;
+  }
+
+  void QPSolver::computeJointVelocities(
+      const ctrl::Vector6D& cartesian_velocity,
+      double dt,
+      KDL::JntArray& velocities)
+  {
+    if (dt <= 0.0)
+    {
+      DampedLeastSquaresSolver::computeJointVelocities(cartesian_velocity,dt,velocities);
+      return;
+    }
+
+    // Objective \f$ \frac{1}{2} \dot{q}^T H \dot{q} - g^T \dot{q} \f$
+    m_hessian.noalias() = m_jnt_jacobian.data.transpose() * m_jnt_jacobian.data;
+    m_hessian.diagonal().array() += m_damping * m_damping;
+
+    // The 6x6 system tells whether to damp more near singularities
+    factorizeJacobian();
+    m_hessian.diagonal().array() += getSingularityDamping();
+    m_gradient.noalias() = m_jnt_jacobian.data.transpose() * cartesian_velocity;
+
+    // The bounds of this step's joint velocities and a feasible start.
+    // Joints beyond their limits may only move back.
+    ctrl::VectorND& x = velocities.data;
+    for (int i = 0; i < m_number_joints; ++i)
+    {
+      m_lower(i) = std::min((m_lower_pos_limits(i) - m_last_positions(i)) / dt, 0.0);
+      m_upper(i) = std::max((m_upper_pos_limits(i) - m_last_positions(i)) / dt, 0.0);
+      x(i) = 0.0;
+      m_bounds[i] = FREE;
+    }
+
+    // Each round either blocks a joint at a bound or releases one, so
+    // the loop terminates well before this limit in practice.
+    const double eps = 1.0e-12;
+    for (int round = 0; round < 3 * m_number_joints + 1; ++round)
+    {
+      // Minimize over the free joints with the active ones fixed
+      m_reduced_hessian = m_hessian;
+      m_reduced_gradient = m_gradient;
+      for (int i = 0; i < m_number_joints; ++i)
+      {
+        if (m_bounds[i] == FREE)
+        {
+          continue;
+        }
+        m_reduced_gradient -= m_hessian.col(i) * x(i);
+        m_reduced_hessian.row(i).setZero();
+        m_reduced_hessian.col(i).setZero();
+        m_reduced_hessian(i,i) = 1.0;
+      }
+      for (int i = 0; i < m_number_joints; ++i)
+      {
+        if (m_bounds[i] != FREE)
+        {
+          m_reduced_gradient(i) = x(i);
+        }
+      }
+      m_decomposition.compute(m_reduced_hessian);
+      m_candidate = m_decomposition.solve(m_reduced_gradient);
+
+      // Step towards the candidate until the first free joint hits a bound
+      double step = 1.0;
+      int blocking = -1;
+      Bound blocking_bound = FREE;
+      for (int i = 0; i < m_number_joints; ++i)
+      {
+        if (m_bounds[i] != FREE)
+        {
+          continue;
+        }
+        const double direction = m_candidate(i) - x(i);
+        if (m_candidate(i) < m_lower(i) - eps && direction < 0.0)
+        {
+          const double limit = (m_lower(i) - x(i)) / direction;
+          if (limit < step)
+          {
+            step = limit;
+            blocking = i;
+            blocking_bound = AT_LOWER;
+          }
+        }
+        else if (m_candidate(i) > m_upper(i) + eps && direction > 0.0)
+        {
+          const double limit = (m_upper(i) - x(i)) / direction;
+          if (limit < step)
+          {
+            step = limit;
+            blocking = i;
+            blocking_bound = AT_UPPER;
+          }
+        }
+      }
+      x += step * (m_candidate - x);
+
+      if (blocking >= 0)
+      {
+        m_bounds[blocking] = blocking_bound;
+        x(blocking) = blocking_bound == AT_LOWER ? m_lower(blocking) : m_upper(blocking);
+        continue;
+      }
+
+      // Optimal for this active set. Release the bound whose multiplier
+      // has the wrong sign the most, i.e. where moving away from the
+      // bound would decrease the objective.
+      m_residual.noalias() = m_hessian * x;
+      m_residual -= m_gradient;
+      int release = -1;
+      double worst = eps;
+      for (int i = 0; i < m_number_joints; ++i)
+      {
+        const double pull =
+          m_bounds[i] == AT_LOWER ? -m_residual(i) :
+          m_bounds[i] == AT_UPPER ? m_residual(i) : 0.0;
+        if (pull > worst)
+        {
+          worst = pull;
+          release = i;
+        }
+      }
+      if (release < 0)
+      {
+        break;
+      }
+      m_bounds[release] = FREE;
+    }
+  }
+
+} // namespace
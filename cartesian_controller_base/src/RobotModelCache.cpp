@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    RobotModelCache.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/RobotModelCache.h>
+
+// KDL
+#include <kdl_parser/kdl_parser.hpp>
+
+// Other
+#include <boost/functional/hash.hpp>
+
+namespace cartesian_controller_base
+{
+
+std::map<std::size_t, RobotModelCache::Entry> RobotModelCache::s_entries;
+boost::mutex RobotModelCache::s_mutex;
+
+RobotModelCache::UrdfPtr RobotModelCache::getUrdf(const std::string& robot_description)
+{
+  boost::mutex::scoped_lock lock(s_mutex);
+  return getEntry(robot_description).urdf;
+}
+
+RobotModelCache::TreePtr RobotModelCache::getTree(const std::string& robot_description)
+{
+  boost::mutex::scoped_lock lock(s_mutex);
+  return getEntry(robot_description).tree;
+}
+
+RobotModelCache::ChainPtr RobotModelCache::getChain(
+    const std::string& robot_description,
+    const std::string& base_link,
+    const std::string& tip_link)
+{
+  boost::mutex::scoped_lock lock(s_mutex);
+  Entry& entry = getEntry(robot_description);
+  if (!entry.tree)
+  {
+    return ChainPtr();
+  }
+
+  const std::string key = base_link + " " + tip_link;
+  std::map<std::string, ChainPtr>::const_iterator it = entry.chains.find(key);
+  if (it != entry.chains.end())
+  {
+    return it->second;
+  }
+
+  boost::shared_ptr<KDL::Chain> chain(new KDL::Chain());
+  if (!entry.tree->getChain(base_link,tip_link,*chain))
+  {
+    // Don't cache failures. These are configuration errors.
+    return ChainPtr();
+  }
+  entry.chains[key] = chain;
+  return chain;
+}
+
+RobotModelCache::Entry& RobotModelCache::getEntry(const std::string& robot_description)
+{
+  Entry& entry = s_entries[boost::hash<std::string>()(robot_description)];
+  if (entry.urdf && entry.robot_description == robot_description)
+  {
+    return entry;
+  }
+
+  // New or changed robot description
+  entry = Entry();
+  entry.robot_description = robot_description;
+
+  boost::shared_ptr<urdf::Model> urdf(new urdf::Model());
+  if (!urdf->initString(robot_description))
+  {
+    return entry;
+  }
+  entry.urdf = urdf;
+
+  boost::shared_ptr<KDL::Tree> tree(new KDL::Tree());
+  if (kdl_parser::treeFromUrdfModel(*urdf,*tree))
+  {
+    entry.tree = tree;
+  }
+  return entry;
+}
+
+} // namespace
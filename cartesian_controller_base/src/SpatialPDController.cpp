@@ -42,43 +42,165 @@
 
 // Other
 #include <string>
+#include <vector>
+#include <stdexcept>
 
 namespace cartesian_controller_base
 {
 
 SpatialPDController::SpatialPDController()
+  : m_cmd(ctrl::Vector6D::Zero())
+  , m_last_p_error(ctrl::Vector6D::Zero())
+  , m_reset(false)
+  , m_active_gains(NULL)
 {
 }
 
 ctrl::Vector6D SpatialPDController::operator()(const ctrl::Vector6D& error, const ros::Duration& period)
 {
-  // Perform pd control separately on each Cartesian dimension
-  for (int i = 0; i < 6; ++i) // 3 transition, 3 rotation
+  if (period == ros::Duration(0.0))
+  {
+    m_cmd.setZero();
+    return m_cmd;
+  }
+
+  if (m_reset)
+  {
+    m_last_p_error = error;
+    m_reset = false;
+  }
+
+  // Perform pd control on all Cartesian dimensions at once
+  if (!m_active_gains)
+  {
+    updateGains();
+  }
+  const Gains& gains = *m_active_gains;
+  const double dt = period.toSec();
+  if (gains.coupled)
+  {
+    m_cmd.noalias() = gains.p_matrix * error + gains.d_matrix * (error - m_last_p_error) / dt;
+  }
+  else
   {
-    m_cmd(i) = m_pd_controllers[i](error[i],period);
+    m_cmd = gains.p.cwiseProduct(error) + gains.d.cwiseProduct(error - m_last_p_error) / dt;
   }
+  m_last_p_error = error;
   return m_cmd;
 }
 
+void SpatialPDController::reset()
+{
+  m_reset = true;
+}
+
+void SpatialPDController::updateGains()
+{
+  // Valid until the next read
+  m_active_gains = m_gains.readFromRT();
+}
+
 bool SpatialPDController::init(ros::NodeHandle& nh)
 {
-  // Initialize pd controllers for each Cartesian dimension
+  std::string solver_config = nh.getNamespace() + "/pd_gains";
+  ros::NodeHandle pd_nh(solver_config);
+
+  // Support the per-axis layout of earlier versions, e.g. pd_gains/trans_x/p
+  const char* axes[6] = {"trans_x", "trans_y", "trans_z", "rot_x", "rot_y", "rot_z"};
+  const char* gains[2] = {"p", "d"};
   for (int i = 0; i < 6; ++i) // 3 transition, 3 rotation
   {
-    m_pd_controllers.push_back(PDController());
+    for (int j = 0; j < 2; ++j)
+    {
+      const std::string name = std::string(axes[i]) + "_" + gains[j];
+      double value;
+      if (!pd_nh.hasParam(name) &&
+          pd_nh.getParam(std::string(axes[i]) + "/" + gains[j],value))
+      {
+        pd_nh.setParam(name,value);
+      }
+    }
   }
 
-  // Load default controller gains
-  std::string solver_config = nh.getNamespace() + "/pd_gains";
+  // Optional coupling of axes
+  const bool p_coupled = loadGainMatrix(pd_nh,"p_matrix",m_config_gains.p_matrix);
+  const bool d_coupled = loadGainMatrix(pd_nh,"d_matrix",m_config_gains.d_matrix);
+  m_config_gains.coupled = p_coupled || d_coupled;
+  if (m_config_gains.coupled)
+  {
+    // Start the sliders with the matrices' diagonals
+    for (int i = 0; i < 6; ++i)
+    {
+      if (p_coupled && !pd_nh.hasParam(std::string(axes[i]) + "_p"))
+      {
+        pd_nh.setParam(std::string(axes[i]) + "_p",m_config_gains.p_matrix(i,i));
+      }
+      if (d_coupled && !pd_nh.hasParam(std::string(axes[i]) + "_d"))
+      {
+        pd_nh.setParam(std::string(axes[i]) + "_d",m_config_gains.d_matrix(i,i));
+      }
+    }
+  }
+
+  // Connect dynamic reconfigure and overwrite the default values with values
+  // on the parameter server. This is done automatically if parameters with
+  // the according names exist.
+  m_callback_type = boost::bind(
+      &SpatialPDController::dynamicReconfigureCallback, this, _1, _2);
 
-  m_pd_controllers[0].init(solver_config + "/trans_x");
-  m_pd_controllers[1].init(solver_config + "/trans_y");
-  m_pd_controllers[2].init(solver_config + "/trans_z");
-  m_pd_controllers[3].init(solver_config + "/rot_x");
-  m_pd_controllers[4].init(solver_config + "/rot_y");
-  m_pd_controllers[5].init(solver_config + "/rot_z");
+  m_dyn_conf_server.reset(
+      new dynamic_reconfigure::Server<SpatialPDGainsConfig>(pd_nh));
+  m_dyn_conf_server->setCallback(m_callback_type);
 
   return true;
 }
 
+bool SpatialPDController::loadGainMatrix(ros::NodeHandle& nh, const std::string& name, ctrl::Matrix6D& matrix)
+{
+  std::vector<double> values;
+  if (!nh.getParam(name,values))
+  {
+    return false;
+  }
+  if (values.size() != 36)
+  {
+    const std::string error = ""
+      "The gain matrix " + nh.getNamespace() + "/" + name + " needs 36 values (row-major)";
+    ROS_ERROR_STREAM(error);
+    throw std::runtime_error(error);
+  }
+  for (int i = 0; i < 6; ++i)
+  {
+    for (int j = 0; j < 6; ++j)
+    {
+      matrix(i,j) = values[i * 6 + j];
+    }
+  }
+  return true;
+}
+
+void SpatialPDController::dynamicReconfigureCallback(SpatialPDGainsConfig& config, uint32_t level)
+{
+  m_config_gains.p <<
+    config.trans_x_p,
+    config.trans_y_p,
+    config.trans_z_p,
+    config.rot_x_p,
+    config.rot_y_p,
+    config.rot_z_p;
+
+  m_config_gains.d <<
+    config.trans_x_d,
+    config.trans_y_d,
+    config.trans_z_d,
+    config.rot_x_d,
+    config.rot_y_d,
+    config.rot_z_d;
+
+  m_config_gains.p_matrix.diagonal() = m_config_gains.p;
+  m_config_gains.d_matrix.diagonal() = m_config_gains.d;
+
+  m_gains.writeFromNonRT(m_config_gains);
+}
+
 } // namespace
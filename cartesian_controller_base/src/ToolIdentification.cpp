@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    ToolIdentification.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/ToolIdentification.h>
+
+namespace cartesian_controller_base
+{
+
+namespace
+{
+  //! Initial uncertainty of all unknowns
+  const double INITIAL_COVARIANCE = 1.0e3;
+}
+
+ToolIdentification::ToolIdentification(double forgetting_factor)
+  : m_forgetting_factor(forgetting_factor)
+{
+  reset();
+}
+
+void ToolIdentification::reset()
+{
+  m_samples = 0;
+  m_force_estimate.setZero();
+  m_force_covariance = INITIAL_COVARIANCE * Matrix4D::Identity();
+  m_torque_estimate.setZero();
+  m_torque_covariance = INITIAL_COVARIANCE * ctrl::Matrix6D::Identity();
+}
+
+void ToolIdentification::update(const ctrl::Vector3D& gravity, const ctrl::Vector6D& wrench)
+{
+  // Regressors of f = [g I] (m, f_0) and tau = [-[g]x I] (m c, tau_0)
+  Matrix34D force_regressor;
+  force_regressor.col(0) = gravity;
+  force_regressor.rightCols<3>().setIdentity();
+
+  ctrl::Matrix3D skew;
+  skew <<
+            0.0,  gravity[2], -gravity[1],
+    -gravity[2],         0.0,  gravity[0],
+     gravity[1], -gravity[0],         0.0;
+  Matrix36D torque_regressor;
+  torque_regressor.leftCols<3>() = skew;
+  torque_regressor.rightCols<3>().setIdentity();
+
+  // Recursive least squares with a 3x3 innovation for each
+  const double lambda = m_forgetting_factor;
+  {
+    const Matrix34D ap = force_regressor * m_force_covariance;
+    const ctrl::Matrix3D s = lambda * ctrl::Matrix3D::Identity() + ap * force_regressor.transpose();
+    const Eigen::Matrix<double,4,3> gain = s.ldlt().solve(ap).transpose();
+    m_force_estimate += gain * (wrench.head<3>() - force_regressor * m_force_estimate);
+    m_force_covariance = (m_force_covariance - gain * ap) / lambda;
+  }
+  {
+    const Matrix36D ap = torque_regressor * m_torque_covariance;
+    const ctrl::Matrix3D s = lambda * ctrl::Matrix3D::Identity() + ap * torque_regressor.transpose();
+    const Eigen::Matrix<double,6,3> gain = s.ldlt().solve(ap).transpose();
+    m_torque_estimate += gain * (wrench.tail<3>() - torque_regressor * m_torque_estimate);
+    m_torque_covariance = (m_torque_covariance - gain * ap) / lambda;
+  }
+  ++m_samples;
+}
+
+ctrl::Vector3D ToolIdentification::centerOfMass() const
+{
+  if (mass() <= 0.0)
+  {
+    return ctrl::Vector3D::Zero();
+  }
+  return m_torque_estimate.head<3>() / mass();
+}
+
+bool ToolIdentification::converged() const
+{
+  // Uncertainty of the mass and the first moment of mass
+  const double threshold = 1.0e-3 * INITIAL_COVARIANCE;
+  return mass() > 0.0
+    && m_force_covariance(0,0) < threshold
+    && m_torque_covariance.topLeftCorner<3,3>().trace() < threshold;
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    WorkerPool.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/WorkerPool.h>
+
+// ROS
+#include <ros/ros.h>
+
+// Other
+#include <pthread.h>
+#include <sched.h>
+#include <boost/bind.hpp>
+
+namespace cartesian_controller_base
+{
+
+WorkerPool::WorkerPool()
+  : m_generation(0)
+  , m_shutdown(false)
+  , m_pending(0)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+  shutdown();
+}
+
+bool WorkerPool::init(const std::vector<Task>& tasks, const std::vector<int>& cpus, int priority)
+{
+  shutdown();
+  m_tasks = tasks;
+  m_generation = 0;
+  m_shutdown = false;
+
+  bool success = true;
+  for (size_t i = 1; i < m_tasks.size(); ++i)
+  {
+    m_workers.push_back(boost::shared_ptr<boost::thread>(
+          new boost::thread(boost::bind(&WorkerPool::work, this, i))));
+    pthread_t handle = m_workers.back()->native_handle();
+
+    if (i - 1 < cpus.size())
+    {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cpus[i - 1], &cpu_set);
+      if (pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpu_set) != 0)
+      {
+        ROS_WARN_STREAM("WorkerPool: Failed to pin worker " << i << " to CPU " << cpus[i - 1]);
+        success = false;
+      }
+    }
+
+    if (priority > 0)
+    {
+      sched_param param;
+      param.sched_priority = priority;
+      if (pthread_setschedparam(handle, SCHED_FIFO, &param) != 0)
+      {
+        ROS_WARN_STREAM("WorkerPool: Failed to set realtime priority " << priority
+            << " for worker " << i << ". Check your user's rtprio limits.");
+        success = false;
+      }
+    }
+  }
+  return success;
+}
+
+void WorkerPool::run()
+{
+  if (m_tasks.empty())
+  {
+    return;
+  }
+
+  // Wake up all workers for the next round
+  m_pending.store(m_workers.size(), boost::memory_order_relaxed);
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  m_tasks[0]();
+
+  // Barrier. The workers should be about as fast as the first task.
+  // Yield in case they share this thread's CPU.
+  while (m_pending.load(boost::memory_order_acquire) > 0)
+  {
+    boost::this_thread::yield();
+  }
+}
+
+void WorkerPool::work(int task)
+{
+  unsigned long done = 0;
+  while (true)
+  {
+    {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while (m_generation == done && !m_shutdown)
+      {
+        m_start.wait(lock);
+      }
+      if (m_shutdown)
+      {
+        return;
+      }
+      done = m_generation;
+    }
+
+    m_tasks[task]();
+    m_pending.fetch_sub(1, boost::memory_order_release);
+  }
+}
+
+void WorkerPool::shutdown()
+{
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_start.notify_all();
+  for (size_t i = 0; i < m_workers.size(); ++i)
+  {
+    m_workers[i]->join();
+  }
+  m_workers.clear();
+}
+
+} // namespace
@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    WrenchFilter.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/WrenchFilter.h>
+
+// Other
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cartesian_controller_base
+{
+
+WrenchFilter::WrenchFilter()
+  : m_window_size(1)
+  , m_window_count(0)
+  , m_window_index(0)
+  , m_median(ctrl::Vector6D::Zero())
+  , m_order(0)
+  , m_output(ctrl::Vector6D::Zero())
+  , m_reset(true)
+{
+  std::fill(m_b,m_b + MAX_ORDER + 1,0.0);
+  std::fill(m_a,m_a + MAX_ORDER + 1,0.0);
+  m_b[0] = 1.0;
+  m_a[0] = 1.0;
+  for (int i = 0; i < MAX_ORDER; ++i)
+  {
+    m_state[i].setZero();
+  }
+}
+
+bool WrenchFilter::init(ros::NodeHandle& nh)
+{
+  nh.param("median_window",m_window_size,1);
+  if (m_window_size < 1 || m_window_size > MAX_MEDIAN_WINDOW || m_window_size % 2 == 0)
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << "/median_window must be an odd number from 1 to "
+        << MAX_MEDIAN_WINDOW << ". Got " << m_window_size);
+    return false;
+  }
+
+  std::vector<double> b;
+  std::vector<double> a;
+  double cutoff_frequency = 0.0;
+  if (nh.getParam("b",b))
+  {
+    if (!nh.getParam("a",a))
+    {
+      a.assign(1,1.0); // FIR
+    }
+  }
+  else if (nh.getParam("cutoff_frequency",cutoff_frequency) && cutoff_frequency > 0.0)
+  {
+    double sample_rate = 0.0;
+    if (!nh.getParam("sample_rate",sample_rate) || cutoff_frequency >= sample_rate / 2.0)
+    {
+      ROS_ERROR_STREAM(nh.getNamespace() << "/cutoff_frequency needs a "
+          << nh.getNamespace() << "/sample_rate of more than twice its value");
+      return false;
+    }
+
+    // Second-order Butterworth with the bilinear transform
+    const double k = std::tan(M_PI * cutoff_frequency / sample_rate);
+    const double norm = 1.0 / (1.0 + std::sqrt(2.0) * k + k * k);
+    b.resize(3);
+    a.resize(3);
+    b[0] = k * k * norm;
+    b[1] = 2.0 * b[0];
+    b[2] = b[0];
+    a[0] = 1.0;
+    a[1] = 2.0 * (k * k - 1.0) * norm;
+    a[2] = (1.0 - std::sqrt(2.0) * k + k * k) * norm;
+  }
+  else
+  {
+    b.assign(1,1.0); // Pass through
+    a.assign(1,1.0);
+  }
+
+  if (!setCoefficients(b,a))
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << ": Need 1 to " << MAX_ORDER + 1
+        << " filter coefficients in b and a, and a[0] must not be zero");
+    return false;
+  }
+
+  reset();
+  return true;
+}
+
+const ctrl::Vector6D& WrenchFilter::operator()(const ctrl::Vector6D& sample)
+{
+  return lowPass(median(sample));
+}
+
+void WrenchFilter::reset()
+{
+  m_reset = true;
+}
+
+const ctrl::Vector6D& WrenchFilter::median(const ctrl::Vector6D& sample)
+{
+  if (m_window_size == 1)
+  {
+    m_median = sample;
+    return m_median;
+  }
+
+  if (m_reset)
+  {
+    std::fill(m_window,m_window + m_window_size,sample);
+    m_window_index = 0;
+  }
+  m_window[m_window_index] = sample;
+  m_window_index = (m_window_index + 1) % m_window_size;
+
+  double values[MAX_MEDIAN_WINDOW];
+  for (int axis = 0; axis < 6; ++axis)
+  {
+    for (int i = 0; i < m_window_size; ++i)
+    {
+      values[i] = m_window[i][axis];
+    }
+    std::nth_element(values,values + m_window_size / 2,values + m_window_size);
+    m_median[axis] = values[m_window_size / 2];
+  }
+  return m_median;
+}
+
+const ctrl::Vector6D& WrenchFilter::lowPass(const ctrl::Vector6D& sample)
+{
+  if (m_reset)
+  {
+    // Steady state for a constant input, computed from the last state backwards
+    double sum_b = 0.0;
+    double sum_a = 0.0;
+    for (int i = 0; i <= m_order; ++i)
+    {
+      sum_b += m_b[i];
+      sum_a += m_a[i];
+    }
+    const ctrl::Vector6D steady_output =
+      std::abs(sum_a) > 1.0e-12 ? ctrl::Vector6D(sample * sum_b / sum_a) : sample;
+
+    ctrl::Vector6D next = ctrl::Vector6D::Zero();
+    for (int i = m_order - 1; i >= 0; --i)
+    {
+      m_state[i] = m_b[i + 1] * sample - m_a[i + 1] * steady_output + next;
+      next = m_state[i];
+    }
+    m_reset = false;
+  }
+
+  m_output = m_b[0] * sample;
+  if (m_order > 0)
+  {
+    m_output += m_state[0];
+  }
+  for (int i = 0; i < m_order; ++i)
+  {
+    m_state[i] = m_b[i + 1] * sample - m_a[i + 1] * m_output;
+    if (i + 1 < m_order)
+    {
+      m_state[i] += m_state[i + 1];
+    }
+  }
+  return m_output;
+}
+
+bool WrenchFilter::setCoefficients(const std::vector<double>& b, const std::vector<double>& a)
+{
+  if (b.empty() || a.empty() ||
+      static_cast<int>(b.size()) > MAX_ORDER + 1 ||
+      static_cast<int>(a.size()) > MAX_ORDER + 1 ||
+      a[0] == 0.0)
+  {
+    return false;
+  }
+
+  m_order = static_cast<int>(std::max(b.size(),a.size())) - 1;
+  for (int i = 0; i <= MAX_ORDER; ++i)
+  {
+    m_b[i] = i < static_cast<int>(b.size()) ? b[i] / a[0] : 0.0;
+    m_a[i] = i < static_cast<int>(a.size()) ? a[i] / a[0] : 0.0;
+  }
+  return true;
+}
+
+} // namespace
@@ -42,14 +42,23 @@
 
 // Project
 #include <cartesian_controller_base/cartesian_controller_base.h>
+#include <cartesian_controller_base/RobotModelCache.h>
+#include <cartesian_controller_base/ForwardDynamicsSolver.h>
+#include <cartesian_controller_base/DampedLeastSquaresSolver.h>
 
 // KDL
-#include <kdl/tree.hpp>
-#include <kdl_parser/kdl_parser.hpp>
 #include <kdl/jntarray.hpp>
 
-// URDF
-#include <urdf/model.h>
+// ros_controls
+#include <joint_limits_interface/joint_limits_rosparam.h>
+#include <joint_limits_interface/joint_limits_urdf.h>
+
+// Other
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <limits>
+#include <boost/type_traits/is_same.hpp>
 
 namespace cartesian_controller_base
 {
@@ -71,9 +80,9 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   }
 
   std::string robot_description;
-  urdf::Model robot_model;
-  KDL::Tree   robot_tree;
-  KDL::Chain  robot_chain;
+  RobotModelCache::UrdfPtr  robot_model;
+  RobotModelCache::TreePtr  robot_tree;
+  RobotModelCache::ChainPtr robot_chain;
 
   // Get controller specific configuration
   if (!nh.getParam("/robot_description",robot_description))
@@ -92,20 +101,24 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
     return false;
   }
 
-  // Build a kinematic chain of the robot
-  if (!robot_model.initString(robot_description))
+  // Build a kinematic chain of the robot.
+  // Other controllers on the same robot share the parsed models.
+  robot_model = RobotModelCache::getUrdf(robot_description);
+  if (!robot_model)
   {
     ROS_ERROR("Failed to parse urdf model from 'robot_description'");
     return false;
   }
-  if (!kdl_parser::treeFromUrdfModel(robot_model,robot_tree))
+  robot_tree = RobotModelCache::getTree(robot_description);
+  if (!robot_tree)
   {
     const std::string error = ""
       "Failed to parse KDL tree from urdf model";
     ROS_ERROR_STREAM(error);
     throw std::runtime_error(error);
   }
-  if (!robot_tree.getChain(m_robot_base_link,m_end_effector_link,robot_chain))
+  robot_chain = RobotModelCache::getChain(robot_description,m_robot_base_link,m_end_effector_link);
+  if (!robot_chain)
   {
     const std::string error = ""
       "Failed to parse robot chain from urdf model. "
@@ -123,33 +136,104 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
     throw std::runtime_error(error);
   }
 
-  // Parse joint limits
+  // Parse joint limits.
+  // Parameters such as joint_limits/<joint>/max_velocity in the
+  // controller's namespace overwrite those of the URDF. Continuous joints
+  // and missing limits are unbounded.
+  const double inf = std::numeric_limits<double>::infinity();
   KDL::JntArray upper_pos_limits(m_joint_names.size());
   KDL::JntArray lower_pos_limits(m_joint_names.size());
+  KDL::JntArray max_velocities(m_joint_names.size());
+  KDL::JntArray max_accelerations(m_joint_names.size());
+  m_max_efforts.resize(m_joint_names.size());
   for (size_t i = 0; i < m_joint_names.size(); ++i)
   {
-    if (!robot_model.getJoint(m_joint_names[i]))
+    urdf::JointConstSharedPtr joint = robot_model->getJoint(m_joint_names[i]);
+    if (!joint)
     {
       const std::string error = ""
         "Joint " + m_joint_names[i] + " does not appear in /robot_description";
       ROS_ERROR_STREAM(error);
       throw std::runtime_error(error);
     }
-    upper_pos_limits(i) = robot_model.getJoint(m_joint_names[i])->limits->upper;
-    lower_pos_limits(i) = robot_model.getJoint(m_joint_names[i])->limits->lower;
+    joint_limits_interface::JointLimits limits;
+    joint_limits_interface::getJointLimits(joint,limits);
+    joint_limits_interface::getJointLimits(m_joint_names[i],nh,limits);
+
+    const bool bounded = limits.has_position_limits && !limits.angle_wraparound;
+    upper_pos_limits(i) = bounded ? limits.max_position : inf;
+    lower_pos_limits(i) = bounded ? limits.min_position : -inf;
+    max_velocities(i) =
+      limits.has_velocity_limits && limits.max_velocity > 0.0 ? limits.max_velocity : inf;
+    max_accelerations(i) =
+      limits.has_acceleration_limits && limits.max_acceleration > 0.0 ? limits.max_acceleration : inf;
+    m_max_efforts(i) =
+      limits.has_effort_limits && limits.max_effort > 0.0 ? limits.max_effort : inf;
   }
 
-  // Get the joint handles to use in the control loop
+  // Get the joint handles to use in the control loop.
+  // Their state is read through the common JointStateHandle.
   for (size_t i = 0; i < m_joint_names.size(); ++i)
   {
-    m_joint_handles.push_back(hw->getHandle(m_joint_names[i]));
+    m_joint_cmd_handles.push_back(hw->getHandle(m_joint_names[i]));
+    m_joint_handles.push_back(m_joint_cmd_handles.back());
   }
 
+  // Preallocate the buffers for the joint commands
+  m_simulated_joint_motion.resize(m_joint_names.size());
+  KDL::SetToZero(m_simulated_joint_motion.q);
+  KDL::SetToZero(m_simulated_joint_motion.qdot);
+  m_last_cmd_positions.resize(m_joint_names.size());
+  KDL::SetToZero(m_last_cmd_positions);
+  m_last_cmd_velocities.resize(m_joint_names.size());
+  KDL::SetToZero(m_last_cmd_velocities);
+  m_cmd_accelerations.resize(m_joint_names.size());
+  KDL::SetToZero(m_cmd_accelerations);
+  m_joint_efforts.resize(m_joint_names.size());
+  KDL::SetToZero(m_joint_efforts);
+
   // Initialize solvers
-  m_forward_dynamics_solver.init(robot_chain,upper_pos_limits,lower_pos_limits);
-  KDL::Tree tmp("not_relevant");
-  tmp.addChain(robot_chain,"not_relevant");
-  m_forward_kinematics_solver.reset(new KDL::TreeFkSolverPos_recursive(tmp));
+  std::string solver_type;
+  nh.param<std::string>("solver/type",solver_type,"forward_dynamics");
+  m_ik_solver.reset(IKSolver::create(solver_type));
+  if (!m_ik_solver)
+  {
+    const std::string error = ""
+      "Unknown solver/type " + solver_type + ". "
+      "Use forward_dynamics, damped_least_squares or qp";
+    ROS_ERROR_STREAM(error);
+    throw std::runtime_error(error);
+  }
+  m_ik_solver->init(*robot_chain,upper_pos_limits,lower_pos_limits);
+  m_ik_solver->setMotionLimits(max_velocities,max_accelerations);
+
+  // Resolve link names to the solver's segment indices.
+  // The robot base link is the chain's root.
+  m_base_link_frame = KDL::Frame::Identity();
+  m_robot_chain = robot_chain;
+  m_link_indices[m_robot_base_link] = -1;
+  for (size_t i = 0; i < robot_chain->segments.size(); ++i)
+  {
+    m_link_indices[robot_chain->segments[i].getName()] = i;
+  }
+  m_end_effector_link_index = getLinkIndex(m_end_effector_link);
+
+  // Optionally keep a second solver warm while inactive
+  nh.param("hot_standby_rate",m_standby_rate,0.0);
+  nh.param("hot_standby/max_joint_offset",m_standby_max_offset,0.001);
+  m_standby_valid = false;
+  m_standby_settings_version = 0;
+  m_warm_start = false;
+  if (m_standby_rate > 0.0)
+  {
+    m_standby_solver.reset(IKSolver::create(solver_type));
+    m_standby_solver->init(*robot_chain,upper_pos_limits,lower_pos_limits);
+    m_standby_solver->setMotionLimits(max_velocities,max_accelerations);
+    m_standby_timer = nh.createTimer(
+        ros::Duration(1.0 / m_standby_rate),
+        &CartesianControllerBase<HardwareInterface>::updateStandbyState,
+        this);
+  }
 
   // Initialize Cartesian pd controllers
   m_spatial_controller.init(nh);
@@ -157,8 +241,8 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   // Connect dynamic reconfigure and overwrite the default values with values
   // on the parameter server. This is done automatically if parameters with
   // the according names exist.
-  m_error_scale = 1.0;
-  m_iterations = 1;
+  m_settings = SolverSettings();
+  m_config_settings = SolverSettings();
   m_callback_type = boost::bind(
       &CartesianControllerBase<HardwareInterface>::dynamicReconfigureCallback, this, _1, _2);
 
@@ -167,12 +251,57 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
         ros::NodeHandle(nh.getNamespace() + "/solver")));
   m_dyn_conf_server->setCallback(m_callback_type);
 
+  // Not running yet, so apply the initial settings right away
+  m_settings = *m_settings_input.readFromRT();
+  applySettings(m_settings,*m_ik_solver);
+  if (m_standby_solver)
+  {
+    boost::mutex::scoped_lock lock(m_standby_mutex);
+    applySettings(m_settings,*m_standby_solver);
+    m_standby_settings_version = m_settings.version;
+  }
+
   m_already_initialized = true;
 
   // Start with normal ROS control behavior
   m_paused = false;
 
-  pub = nh.advertise<geometry_msgs::WrenchStamped>("/cmd", 1000);
+  // Telemetry
+  nh.param("publish_rate/cmd",m_cmd_publish_rate,100.0);
+  m_cmd_publisher.reset(new CmdPublisher(nh,"/cmd",3));
+
+  // Diagnostics are published outside the control loop
+  double diagnostics_rate;
+  nh.param("diagnostics_rate",diagnostics_rate,1.0);
+  m_diagnostics_name = nh.getNamespace();
+  m_reported_cycle_overruns = 0;
+  if (diagnostics_rate > 0.0)
+  {
+    m_diagnostics_publisher = nh.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+    m_diagnostics_timer = nh.createTimer(
+        ros::Duration(1.0 / diagnostics_rate),
+        &CartesianControllerBase<HardwareInterface>::publishDiagnostics,
+        this);
+  }
+
+  // Optionally keep the most recent cycles for offline analysis
+  int recorder_capacity;
+  nh.param("recorder/capacity",recorder_capacity,0);
+  nh.param<std::string>("recorder/directory",m_recorder_directory,"/tmp");
+  nh.param("recorder/dump_on_overrun",m_recorder_dump_on_overrun,false);
+  m_recorder.init(m_joint_names.size(),recorder_capacity,solver_type,
+      boost::is_same<HardwareInterface,hardware_interface::EffortJointInterface>::value);
+  if (m_recorder.enabled())
+  {
+    m_recorder_service = nh.advertiseService(
+        "recorder/dump",
+        &CartesianControllerBase<HardwareInterface>::dumpRecordsCallback,
+        this);
+    m_recorder_timer = nh.createTimer(
+        ros::Duration(0.1),
+        &CartesianControllerBase<HardwareInterface>::dumpRecords,
+        this);
+  }
 
   return true;
 }
@@ -181,9 +310,86 @@ template <class HardwareInterface>
 void CartesianControllerBase<HardwareInterface>::
 starting(const ros::Time& time)
 {
-  // Copy joint state to internal simulation
-  m_forward_dynamics_solver.setStartState(m_joint_handles);
-  m_forward_dynamics_solver.updateKinematics<HardwareInterface>(m_joint_handles);
+  m_last_cmd_publish_time = time;
+
+  // This gets called more than once in multiple inheritance scenarios.
+  // Don't overwrite a warm start of the same activation.
+  if (m_warm_start && time == m_start_time)
+  {
+    return;
+  }
+  m_start_time = time;
+  m_warm_start = false;
+
+  // The commands of the first cycle start from the real joint motion
+  for (size_t i = 0; i < m_joint_handles.size(); ++i)
+  {
+    m_last_cmd_positions(i) = m_joint_handles[i].getPosition();
+    m_last_cmd_velocities(i) = m_joint_handles[i].getVelocity();
+  }
+
+  // Start the derivative parts with the first new error
+  m_spatial_controller.reset();
+
+  // Take over the cached kinematics from hot standby if they are recent
+  // and the joints are still close enough to reuse them.
+  // Cold start if the standby is currently being updated.
+  if (m_standby_rate > 0.0 && m_standby_mutex.try_lock())
+  {
+    if (m_standby_valid && (time - m_standby_stamp).toSec() <= 2.0 / m_standby_rate)
+    {
+      const KDL::JntArray& sample = m_standby_solver->getPositions();
+      double offset = 0.0;
+      for (size_t i = 0; i < m_joint_handles.size(); ++i)
+      {
+        offset = std::max(offset,std::abs(m_joint_handles[i].getPosition() - sample(i)));
+      }
+      if (offset <= m_standby_max_offset)
+      {
+        m_ik_solver->swapState(*m_standby_solver);
+        m_warm_start = true;
+      }
+    }
+    m_standby_valid = false;
+    m_standby_mutex.unlock();
+  }
+
+  // Copy joint state to internal simulation. A warm start keeps the
+  // standby's Jacobian and factorization and only updates the frames.
+  if (m_warm_start)
+  {
+    m_ik_solver->resumeState(m_joint_handles);
+  }
+  else
+  {
+    m_ik_solver->setStartState(m_joint_handles);
+    m_ik_solver->updateKinematics<HardwareInterface>(m_joint_handles);
+  }
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+updateStandbyState(const ros::TimerEvent& event)
+{
+  if (this->isRunning())
+  {
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(m_standby_mutex);
+
+  // Prepare with the settings that the control loop will use
+  const SolverSettings settings = *m_settings_input.readFromNonRT();
+  if (settings.version != m_standby_settings_version)
+  {
+    applySettings(settings,*m_standby_solver);
+    m_standby_settings_version = settings.version;
+  }
+
+  m_standby_solver->setStartState(m_joint_handles);
+  m_standby_solver->updateKinematics<HardwareInterface>(m_joint_handles);
+  m_standby_stamp = ros::Time::now();
+  m_standby_valid = true;
 }
 
 template <class HardwareInterface>
@@ -217,7 +423,7 @@ writeJointControlCmds()
   // Take position commands
   for (size_t i = 0; i < m_joint_handles.size(); ++i)
   {
-    m_joint_handles[i].setCommand(m_simulated_joint_motion.positions[i]);
+    m_joint_cmd_handles[i].setCommand(m_simulated_joint_motion.q(i));
   }
 }
 
@@ -237,18 +443,100 @@ writeJointControlCmds()
   // Take velocity commands
   for (size_t i = 0; i < m_joint_handles.size(); ++i)
   {
-    m_joint_handles[i].setCommand(m_simulated_joint_motion.velocities[i]);
+    m_joint_cmd_handles[i].setCommand(m_simulated_joint_motion.qdot(i));
+  }
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::PosVelJointInterface>::
+writeJointControlCmds()
+{
+  // Don't update commands when paused.
+  if (m_paused)
+  {
+    return;
+  }
+
+  // Take positions and the velocities that reach them in this cycle
+  for (size_t i = 0; i < m_joint_cmd_handles.size(); ++i)
+  {
+    m_joint_cmd_handles[i].setCommand(
+        m_simulated_joint_motion.q(i),
+        m_simulated_joint_motion.qdot(i));
+  }
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::PosVelAccJointInterface>::
+writeJointControlCmds()
+{
+  // Don't update commands when paused.
+  if (m_paused)
+  {
+    return;
+  }
+
+  // Take positions, velocities and the change of velocities since the last
+  // control cycle
+  for (size_t i = 0; i < m_joint_cmd_handles.size(); ++i)
+  {
+    m_joint_cmd_handles[i].setCommand(
+        m_simulated_joint_motion.q(i),
+        m_simulated_joint_motion.qdot(i),
+        m_cmd_accelerations(i));
+  }
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::EffortJointInterface>::
+writeJointControlCmds()
+{
+  // Don't update effort commands when paused.
+  if (m_paused)
+  {
+    return;
+  }
+
+  // Take joint torques
+  for (size_t i = 0; i < m_joint_cmd_handles.size(); ++i)
+  {
+    m_joint_cmd_handles[i].setCommand(m_joint_efforts(i));
+  }
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+publishJointControlCmds(const ros::Time& time)
+{
+  if (m_cmd_publish_rate <= 0.0 ||
+      m_last_cmd_publish_time + ros::Duration(1.0 / m_cmd_publish_rate) > time)
+  {
+    return;
+  }
+
+  // Drop this sample if the publisher thread is still busy
+  if (!m_cmd_publisher->trylock())
+  {
+    return;
+  }
+  m_last_cmd_publish_time = time;
+
+  // Joint velocities of the first six joints
+  KDL::Wrench tmp = KDL::Wrench::Zero();
+  for (size_t i = 0; i < m_joint_handles.size() && i < 6; ++i)
+  {
+    tmp(i) = m_simulated_joint_motion.qdot(i);
   }
-  geometry_msgs::WrenchStamped wrench;
-  wrench.header.stamp = ros::Time::now();
-  wrench.wrench.force.x = m_simulated_joint_motion.velocities[0];
-  wrench.wrench.force.y = m_simulated_joint_motion.velocities[1];
-  wrench.wrench.force.z = m_simulated_joint_motion.velocities[2];
-  wrench.wrench.torque.x = m_simulated_joint_motion.velocities[3];
-  wrench.wrench.torque.y = m_simulated_joint_motion.velocities[4];
-  wrench.wrench.torque.z = m_simulated_joint_motion.velocities[5];
+  geometry_msgs::WrenchStamped& wrench = m_cmd_publisher->msg_;
+  wrench.header.stamp = time;
+  wrench.wrench.force.x = tmp(0);
+  wrench.wrench.force.y = tmp(1);
+  wrench.wrench.force.z = tmp(2);
+  wrench.wrench.torque.x = tmp(3);
+  wrench.wrench.torque.y = tmp(4);
+  wrench.wrench.torque.z = tmp(5);
 
-  pub.publish(wrench);
+  m_cmd_publisher->unlockAndPublish();
 }
 
 template <class HardwareInterface>
@@ -260,13 +548,36 @@ computeJointControlCmds(const ctrl::Vector6D& error, const ros::Duration& period
     return;
   }
 
+  m_solver_statistics.iterations++;
+  m_solver_statistics.residual = error.norm();
+
   // PD controlled system input
-  m_cartesian_input = m_error_scale * m_spatial_controller(error,period);
+  ros::SteadyTime start = startPhase();
+  m_cartesian_input = m_settings.error_scale * m_spatial_controller(error,period);
+  finishPhase(PD_CONTROL,start);
 
   // Simulate one step forward
-  m_simulated_joint_motion = m_forward_dynamics_solver.getJointControlCmds(
-      period,
-      m_cartesian_input);
+  const bool first_step = m_solver_statistics.iterations == 1;
+  if (first_step)
+  {
+    m_recorder.setSolverState(m_ik_solver->getPositions(),m_ik_solver->getVelocities());
+  }
+  start = startPhase();
+  computeJointMotion(period);
+  finishPhase(FORWARD_DYNAMICS,start);
+  if (first_step)
+  {
+    m_recorder.setFirstStep(
+        period,m_cartesian_input,m_simulated_joint_motion.q,m_simulated_joint_motion.qdot,m_joint_efforts);
+  }
+
+  // Conditioning of the solver's last factorization
+  m_solver_statistics.condition_estimate = m_ik_solver->getConditionEstimate();
+  m_solver_statistics.singularity_damping = m_ik_solver->getSingularityDamping();
+  if (m_solver_statistics.singularity_damping > 0.0)
+  {
+    m_solver_statistics.damped_iterations++;
+  }
 
 //  myfile.open("example.txt", std::ios::app);
 //  myfile << ros::Time::now() << ","
@@ -300,13 +611,440 @@ computeJointControlCmds(const ctrl::Vector6D& error, const ros::Duration& period
 //  std::cout << "Time:" << ros::Time::now() << std::endl;
 
   // Update according to control policy for next cycle
-  m_forward_dynamics_solver.updateKinematics<HardwareInterface>(m_joint_handles);
+  updateKinematics(false);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+updateKinematics(bool cycle_start)
+{
+  if (cycle_start)
+  {
+    return;
+  }
+  const ros::SteadyTime start = startPhase();
+  m_ik_solver->updateKinematics<HardwareInterface>(m_joint_handles);
+  finishPhase(KINEMATICS,start);
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::EffortJointInterface>::
+updateKinematics(bool cycle_start)
+{
+  // Torques act on the robot state of this cycle. Take it once, before
+  // anything uses the kinematics.
+  if (!cycle_start)
+  {
+    return;
+  }
+  const ros::SteadyTime start = startPhase();
+  m_ik_solver->updateKinematics<hardware_interface::EffortJointInterface>(m_joint_handles);
+  finishPhase(KINEMATICS,start);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+computeJointMotion(const ros::Duration& period)
+{
+  m_ik_solver->getJointControlCmds(
+      period,
+      m_cartesian_input,
+      m_simulated_joint_motion.q,
+      m_simulated_joint_motion.qdot);
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::EffortJointInterface>::
+computeJointMotion(const ros::Duration& period)
+{
+  // Map the Cartesian input directly to joint torques.
+  // The solver holds the real robot state, see IKSolver::updateKinematics.
+  m_joint_efforts.data.noalias() = m_ik_solver->getJacobian().data.transpose() * m_cartesian_input;
+
+  // There is no simulated motion. Report the real one instead.
+  m_simulated_joint_motion.q.data = m_ik_solver->getPositions().data;
+  m_simulated_joint_motion.qdot.data = m_ik_solver->getVelocities().data;
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+finishJointControlCmds()
+{
+  if (m_paused)
+  {
+    return;
+  }
+
+  // The solver's positions, reached from the last commands within this
+  // cycle, give the velocity commands
+  if (m_ik_solver->limitPositionCommands(
+        m_last_cmd_positions,
+        m_last_cmd_velocities,
+        m_cycle_period,
+        m_simulated_joint_motion.q,
+        m_simulated_joint_motion.qdot))
+  {
+    // Continue where the robot is commanded to go
+    m_ik_solver->setPositions(m_simulated_joint_motion.q);
+  }
+
+  const double dt = m_cycle_period.toSec();
+  for (size_t i = 0; i < m_joint_handles.size(); ++i)
+  {
+    const double velocity = m_simulated_joint_motion.qdot(i);
+    m_cmd_accelerations(i) = dt > 0.0 ? (velocity - m_last_cmd_velocities(i)) / dt : 0.0;
+    m_last_cmd_positions(i) = m_simulated_joint_motion.q(i);
+    m_last_cmd_velocities(i) = velocity;
+  }
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::VelocityJointInterface>::
+finishJointControlCmds()
+{
+  if (m_paused)
+  {
+    return;
+  }
+
+  // The simulation restarts from the real robot state in each cycle.
+  // Only the velocity commands need limiting.
+  m_ik_solver->limitVelocityCommands(
+      m_last_cmd_velocities,
+      m_cycle_period,
+      m_simulated_joint_motion.qdot);
+  m_last_cmd_velocities = m_simulated_joint_motion.qdot;
+}
+
+template <>
+void CartesianControllerBase<hardware_interface::EffortJointInterface>::
+finishJointControlCmds()
+{
+  if (m_paused)
+  {
+    return;
+  }
+
+  // Bound the joint torques by the effort limits
+  m_joint_efforts.data = m_joint_efforts.data.cwiseMin(m_max_efforts.data).cwiseMax(-m_max_efforts.data);
+}
+
+template <class HardwareInterface>
+int CartesianControllerBase<HardwareInterface>::
+getLinkIndex(const std::string& link) const
+{
+  std::map<std::string, int>::const_iterator it = m_link_indices.find(link);
+  if (it == m_link_indices.end())
+  {
+    const std::string error = ""
+      "Link " + link + " is not part of the chain from "
+      + m_robot_base_link + " to " + m_end_effector_link;
+    ROS_ERROR_STREAM(error);
+    throw std::runtime_error(error);
+  }
+  return it->second;
+}
+
+template <class HardwareInterface>
+const KDL::Frame& CartesianControllerBase<HardwareInterface>::
+getLinkFrame(int index)
+{
+  if (index < 0)
+  {
+    return m_base_link_frame;
+  }
+  return m_ik_solver->getSegmentFrames()[index];
+}
+
+template <class HardwareInterface>
+KDL::Rotation CartesianControllerBase<HardwareInterface>::
+getMeasuredLinkOrientation(int index) const
+{
+  KDL::Rotation orientation = m_base_link_frame.M;
+  size_t joint = 0;
+  for (int i = 0; i <= index; ++i)
+  {
+    const KDL::Segment& segment = m_robot_chain->segments[i];
+    double position = 0.0;
+    if (segment.getJoint().getType() != KDL::Joint::None && joint < m_joint_handles.size())
+    {
+      position = m_joint_handles[joint++].getPosition();
+    }
+    orientation = orientation * segment.pose(position).M;
+  }
+  return orientation;
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+startIterations(const ros::Duration& period)
+{
+  m_cycle_start = startPhase();
+  m_cycle_period = period;
+  m_solver_statistics.iterations = 0;
+
+  // Settings for this cycle
+  const SolverSettings& settings = *m_settings_input.readFromRT();
+  if (settings.version != m_settings.version)
+  {
+    m_settings = settings;
+    applySettings(m_settings,*m_ik_solver);
+  }
+  m_spatial_controller.updateGains();
+
+  m_recorder.setJointState(m_joint_handles);
+  updateKinematics(true);
+}
+
+template <class HardwareInterface>
+bool CartesianControllerBase<HardwareInterface>::
+continueIterations(const ctrl::Vector6D& error)
+{
+  if (!m_settings.adaptive_iterations)
+  {
+    return true;
+  }
+
+  m_solver_statistics.residual = error.norm();
+  if (m_solver_statistics.residual < m_settings.convergence_tolerance)
+  {
+    return false;
+  }
+
+  // Stop if the next iteration is expected to exceed the time budget.
+  // Estimate its duration with the average of this cycle's iterations.
+  const int done = m_solver_statistics.iterations;
+  if (done > 0 && m_settings.time_budget > ros::WallDuration(0.0))
+  {
+    const ros::WallDuration elapsed = ros::SteadyTime::now() - m_cycle_start;
+    if (elapsed.toSec() * (done + 1) / done > m_settings.time_budget.toSec())
+    {
+      m_solver_statistics.budget_overruns++;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+finishIterations()
+{
+  finishJointControlCmds();
+
+  const ros::WallDuration cycle = ros::SteadyTime::now() - m_cycle_start;
+  m_solver_statistics.phases[CYCLE].add(cycle);
+  if (cycle.toSec() > m_cycle_period.toSec())
+  {
+    m_solver_statistics.cycle_overruns++;
+    if (m_recorder_dump_on_overrun)
+    {
+      m_recorder.requestDump();
+    }
+  }
+  m_recorder.finishCycle(
+      m_cycle_start.toSec(),
+      m_cycle_period,
+      m_solver_statistics.iterations,
+      cycle.toSec(),
+      m_simulated_joint_motion,
+      m_joint_efforts);
+
+  // Skip this cycle if the diagnostics are being read
+  if (m_statistics_mutex.try_lock())
+  {
+    m_shared_statistics = m_solver_statistics;
+    m_statistics_mutex.unlock();
+  }
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+recordTarget(const KDL::Frame& target)
+{
+  m_recorder.setTarget(target);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+recordWrench(const ctrl::Vector6D& wrench)
+{
+  m_recorder.setWrench(wrench);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+dumpRecords(const ros::TimerEvent& event)
+{
+  if (!m_recorder.frozen())
+  {
+    return;
+  }
+
+  // One file per dump, named after the controller
+  std::string name = m_diagnostics_name;
+  std::replace(name.begin(),name.end(),'/','_');
+  std::stringstream filename;
+  filename << m_recorder_directory << "/cycles" << name << "_" << ros::WallTime::now().toNSec() << ".bin";
+
+  if (m_recorder.dump(filename.str()))
+  {
+    ROS_INFO_STREAM("Recorded control cycles written to " << filename.str());
+  }
+  else
+  {
+    ROS_ERROR_STREAM("Failed to write recorded control cycles to " << filename.str());
+  }
+}
+
+template <class HardwareInterface>
+bool CartesianControllerBase<HardwareInterface>::
+dumpRecordsCallback(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res)
+{
+  m_recorder.requestDump();
+  res.success = true;
+  res.message = "Writing the recorded cycles to " + m_recorder_directory;
+  return true;
+}
+
+template <class HardwareInterface>
+ros::SteadyTime CartesianControllerBase<HardwareInterface>::
+startPhase() const
+{
+  return ros::SteadyTime::now();
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+finishPhase(Phase phase, const ros::SteadyTime& start)
+{
+  m_solver_statistics.phases[phase].add(ros::SteadyTime::now() - start);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+publishDiagnostics(const ros::TimerEvent& event)
+{
+  SolverStatistics statistics;
+  {
+    boost::mutex::scoped_lock lock(m_statistics_mutex);
+    statistics = m_shared_statistics;
+  }
+
+  diagnostic_msgs::DiagnosticStatus status;
+  status.name = m_diagnostics_name + ": solver";
+  status.level = diagnostic_msgs::DiagnosticStatus::OK;
+  status.message = "OK";
+
+  std::stringstream value;
+  diagnostic_msgs::KeyValue key_value;
+
+  key_value.key = "iterations";
+  value << statistics.iterations;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "residual";
+  value.str("");
+  value << statistics.residual;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "time budget overruns";
+  value.str("");
+  value << statistics.budget_overruns;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "cycle overruns";
+  value.str("");
+  value << statistics.cycle_overruns;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "condition estimate";
+  value.str("");
+  value << statistics.condition_estimate;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "singularity damping";
+  value.str("");
+  value << statistics.singularity_damping;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  key_value.key = "damped iterations";
+  value.str("");
+  value << statistics.damped_iterations;
+  key_value.value = value.str();
+  status.values.push_back(key_value);
+
+  // Warn about new overruns since the last report
+  if (statistics.cycle_overruns > m_reported_cycle_overruns)
+  {
+    status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+    status.message = "Control cycle overruns";
+  }
+  m_reported_cycle_overruns = statistics.cycle_overruns;
+
+  // Latencies in microseconds
+  const char* phase_names[NUMBER_PHASES] = {
+    "cycle", "pd control", "forward dynamics", "kinematics", "transforms"};
+  for (int i = 0; i < NUMBER_PHASES; ++i)
+  {
+    const LatencyHistogram& histogram = statistics.phases[i];
+
+    key_value.key = std::string(phase_names[i]) + " mean [us]";
+    value.str("");
+    value << histogram.mean() * 1e6;
+    key_value.value = value.str();
+    status.values.push_back(key_value);
+
+    key_value.key = std::string(phase_names[i]) + " max [us]";
+    value.str("");
+    value << histogram.max() * 1e6;
+    key_value.value = value.str();
+    status.values.push_back(key_value);
+
+    // Print as upper bound: count
+    key_value.key = std::string(phase_names[i]) + " histogram [us]";
+    value.str("");
+    for (int j = 0; j < LatencyHistogram::NUMBER_BUCKETS; ++j)
+    {
+      if (j < LatencyHistogram::NUMBER_BUCKETS - 1)
+      {
+        value << "<=" << LatencyHistogram::bucketUpperBound(j) * 1e6 << ": ";
+      }
+      else
+      {
+        value << "more: ";
+      }
+      value << histogram.bucket(j) << (j < LatencyHistogram::NUMBER_BUCKETS - 1 ? ", " : "");
+    }
+    key_value.value = value.str();
+    status.values.push_back(key_value);
+  }
+
+  diagnostic_msgs::DiagnosticArray array;
+  array.header.stamp = ros::Time::now();
+  array.status.push_back(status);
+  m_diagnostics_publisher.publish(array);
 }
 
 template <class HardwareInterface>
 ctrl::Vector6D CartesianControllerBase<HardwareInterface>::
 displayInBaseLink(const ctrl::Vector6D& vector, const std::string& from)
 {
+  return displayInBaseLink(vector,getLinkIndex(from));
+}
+
+template <class HardwareInterface>
+ctrl::Vector6D CartesianControllerBase<HardwareInterface>::
+displayInBaseLink(const ctrl::Vector6D& vector, int from)
+{
+  const ros::SteadyTime start = startPhase();
+
   // Adjust format
   KDL::Wrench wrench_kdl;
   for (int i = 0; i < 6; ++i)
@@ -314,14 +1052,8 @@ displayInBaseLink(const ctrl::Vector6D& vector, const std::string& from)
     wrench_kdl(i) = vector[i];
   }
 
-  KDL::Frame transform_kdl;
-  m_forward_kinematics_solver->JntToCart(
-      m_forward_dynamics_solver.getPositions(),
-      transform_kdl,
-      from);
-
   // Rotate into new reference frame
-  wrench_kdl = transform_kdl.M * wrench_kdl;
+  wrench_kdl = getLinkFrame(from).M * wrench_kdl;
 
   // Reassign
   ctrl::Vector6D out;
@@ -330,6 +1062,7 @@ displayInBaseLink(const ctrl::Vector6D& vector, const std::string& from)
     out[i] = wrench_kdl(i);
   }
 
+  finishPhase(TRANSFORMS,start);
   return out;
 }
 
@@ -337,12 +1070,17 @@ template <class HardwareInterface>
 ctrl::Matrix6D CartesianControllerBase<HardwareInterface>::
 displayInBaseLink(const ctrl::Matrix6D& tensor, const std::string& from)
 {
+  return displayInBaseLink(tensor,getLinkIndex(from));
+}
+
+template <class HardwareInterface>
+ctrl::Matrix6D CartesianControllerBase<HardwareInterface>::
+displayInBaseLink(const ctrl::Matrix6D& tensor, int from)
+{
+  const ros::SteadyTime start = startPhase();
+
   // Get rotation to base
-  KDL::Frame R_kdl;
-  m_forward_kinematics_solver->JntToCart(
-      m_forward_dynamics_solver.getPositions(),
-      R_kdl,
-      from);
+  const KDL::Frame& R_kdl = getLinkFrame(from);
 
   // Adjust format
   ctrl::Matrix3D R;
@@ -357,12 +1095,20 @@ displayInBaseLink(const ctrl::Matrix6D& tensor, const std::string& from)
       R_kdl.M.data[7],
       R_kdl.M.data[8];
 
-  // Treat diagonal blocks as individual 2nd rank tensors.
-  // Display in base frame.
-  ctrl::Matrix6D tmp = ctrl::Matrix6D::Zero();
-  tmp.topLeftCorner<3,3>() = R * tensor.topLeftCorner<3,3>() * R.transpose();
-  tmp.bottomRightCorner<3,3>() = R * tensor.bottomRightCorner<3,3>() * R.transpose();
+  // Treat all four 3x3 blocks as individual 2nd rank tensors, i.e.
+  // diag(R,R) * tensor * diag(R,R)^T. Display in base frame.
+  ctrl::Matrix6D tmp;
+  ctrl::Matrix3D block;
+  block.noalias() = tensor.topLeftCorner<3,3>() * R.transpose();
+  tmp.topLeftCorner<3,3>().noalias() = R * block;
+  block.noalias() = tensor.topRightCorner<3,3>() * R.transpose();
+  tmp.topRightCorner<3,3>().noalias() = R * block;
+  block.noalias() = tensor.bottomLeftCorner<3,3>() * R.transpose();
+  tmp.bottomLeftCorner<3,3>().noalias() = R * block;
+  block.noalias() = tensor.bottomRightCorner<3,3>() * R.transpose();
+  tmp.bottomRightCorner<3,3>().noalias() = R * block;
 
+  finishPhase(TRANSFORMS,start);
   return tmp;
 }
 
@@ -370,6 +1116,15 @@ template <class HardwareInterface>
 ctrl::Vector6D CartesianControllerBase<HardwareInterface>::
 displayInTipLink(const ctrl::Vector6D& vector, const std::string& to)
 {
+  return displayInTipLink(vector,getLinkIndex(to));
+}
+
+template <class HardwareInterface>
+ctrl::Vector6D CartesianControllerBase<HardwareInterface>::
+displayInTipLink(const ctrl::Vector6D& vector, int to)
+{
+  const ros::SteadyTime start = startPhase();
+
   // Adjust format
   KDL::Wrench wrench_kdl;
   for (int i = 0; i < 6; ++i)
@@ -377,14 +1132,8 @@ displayInTipLink(const ctrl::Vector6D& vector, const std::string& to)
     wrench_kdl(i) = vector[i];
   }
 
-  KDL::Frame transform_kdl;
-  m_forward_kinematics_solver->JntToCart(
-      m_forward_dynamics_solver.getPositions(),
-      transform_kdl,
-      to);
-
   // Rotate into new reference frame
-  wrench_kdl = transform_kdl.M.Inverse() * wrench_kdl;
+  wrench_kdl = getLinkFrame(to).M.Inverse() * wrench_kdl;
 
   // Reassign
   ctrl::Vector6D out;
@@ -393,6 +1142,7 @@ displayInTipLink(const ctrl::Vector6D& vector, const std::string& to)
     out[i] = wrench_kdl(i);
   }
 
+  finishPhase(TRANSFORMS,start);
   return out;
 }
 
@@ -400,8 +1150,44 @@ template <class HardwareInterface>
 void CartesianControllerBase<HardwareInterface>::
 dynamicReconfigureCallback(ControllerConfig& config, uint32_t level)
 {
-  m_error_scale = config.error_scale;
-  m_iterations = config.iterations;
+  // Only hand over complete snapshots
+  m_config_settings.version++;
+  m_config_settings.error_scale = config.error_scale;
+  m_config_settings.iterations = config.iterations;
+  m_config_settings.adaptive_iterations = config.adaptive_iterations;
+  m_config_settings.convergence_tolerance = config.convergence_tolerance;
+  m_config_settings.time_budget = ros::WallDuration(config.time_budget * 1e-6);
+  m_config_settings.internal_period = ros::Duration(config.internal_period);
+  m_config_settings.refactorization_threshold = config.refactorization_threshold;
+  m_config_settings.jacobian_threshold = config.jacobian_threshold;
+  m_config_settings.integrator = config.integrator;
+  m_config_settings.null_space_damping = config.null_space_damping;
+  m_config_settings.damping = config.damping;
+  m_config_settings.singularity_threshold = config.singularity_threshold;
+  m_config_settings.singularity_damping = config.singularity_damping;
+  m_settings_input.writeFromNonRT(m_config_settings);
+}
+
+template <class HardwareInterface>
+void CartesianControllerBase<HardwareInterface>::
+applySettings(const SolverSettings& settings, IKSolver& ik_solver)
+{
+  ik_solver.setJacobianThreshold(settings.jacobian_threshold);
+  ik_solver.setSingularityDamping(
+      settings.singularity_threshold,settings.singularity_damping);
+
+  // Solver specific settings
+  if (ForwardDynamicsSolver* solver = dynamic_cast<ForwardDynamicsSolver*>(&ik_solver))
+  {
+    solver->setRefactorizationThreshold(settings.refactorization_threshold);
+    solver->setIntegrator(
+        static_cast<ForwardDynamicsSolver::Integrator>(settings.integrator));
+    solver->setNullSpaceDamping(settings.null_space_damping);
+  }
+  if (DampedLeastSquaresSolver* solver = dynamic_cast<DampedLeastSquaresSolver*>(&ik_solver))
+  {
+    solver->setDamping(settings.damping);
+  }
 }
 
 } // namespace
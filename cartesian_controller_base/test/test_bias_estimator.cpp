@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_bias_estimator.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/BiasEstimator.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <cmath>
+
+using cartesian_controller_base::BiasEstimator;
+
+TEST(TestBiasEstimator, rejectInvalidParameters)
+{
+  ros::NodeHandle nh("~no_samples");
+  nh.setParam("taring_samples",0);
+  BiasEstimator estimator;
+  EXPECT_FALSE(estimator.init(nh));
+}
+
+TEST(TestBiasEstimator, averageSamplesWhileTaring)
+{
+  ros::NodeHandle nh("~taring");
+  nh.setParam("taring_samples",4);
+  BiasEstimator estimator;
+  ASSERT_TRUE(estimator.init(nh));
+  EXPECT_FALSE(estimator.tracking());
+
+  // Samples outside of taring don't count
+  EXPECT_FALSE(estimator.addSample(ctrl::Vector6D::Constant(100.0)));
+  EXPECT_TRUE(estimator.bias().isZero());
+
+  estimator.startTaring();
+  EXPECT_TRUE(estimator.taring());
+  ctrl::Vector6D sample;
+  sample << 1.0, 2.0, 3.0, 0.1, 0.2, 0.3;
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_FALSE(estimator.addSample(sample * (i + 1)));
+  }
+  EXPECT_TRUE(estimator.addSample(sample * 6.0));
+  EXPECT_FALSE(estimator.taring());
+  EXPECT_TRUE(estimator.bias().isApprox(sample * 3.0));
+
+  // A new taring replaces the old bias
+  estimator.startTaring();
+  for (int i = 0; i < 4; ++i)
+  {
+    estimator.addSample(sample);
+  }
+  EXPECT_TRUE(estimator.bias().isApprox(sample));
+}
+
+TEST(TestBiasEstimator, followDriftButNotContact)
+{
+  const double time_constant = 2.0;
+  const ros::Duration period(0.01);
+  ros::NodeHandle nh("~tracking");
+  nh.setParam("time_constant",time_constant);
+  nh.setParam("force_threshold",1.0);
+  nh.setParam("torque_threshold",0.1);
+  BiasEstimator estimator;
+  ASSERT_TRUE(estimator.init(nh));
+  EXPECT_TRUE(estimator.tracking());
+
+  // Contact leaves the bias alone
+  ctrl::Vector6D contact = ctrl::Vector6D::Zero();
+  contact[2] = 5.0;
+  estimator.track(contact,period);
+  EXPECT_TRUE(estimator.bias().isZero());
+  contact << 0.0, 0.0, 0.0, 0.0, 0.5, 0.0;
+  estimator.track(contact,period);
+  EXPECT_TRUE(estimator.bias().isZero());
+
+  // A constant drift gets tracked like a first-order low-pass filter.
+  // The residual shrinks as the bias catches up.
+  ctrl::Vector6D drift;
+  drift << 0.5, -0.3, 0.2, 0.02, -0.01, 0.03;
+  const int steps = static_cast<int>(time_constant / period.toSec());
+  for (int i = 0; i < steps; ++i)
+  {
+    estimator.track(drift - estimator.bias(),period);
+  }
+  const double alpha = period.toSec() / (time_constant + period.toSec());
+  const double expected = 1.0 - std::pow(1.0 - alpha,steps);
+  EXPECT_TRUE(estimator.bias().isApprox(drift * expected,1.0e-9));
+  EXPECT_NEAR(expected, 1.0 - std::exp(-1.0), 0.01);
+
+  // No tracking during taring
+  const ctrl::Vector6D bias = estimator.bias();
+  estimator.startTaring();
+  estimator.track(drift - bias,period);
+  EXPECT_TRUE(estimator.bias().isApprox(bias));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "test_bias_estimator");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_compact_stream.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/CompactStream.h>
+
+// ROS
+#include <ros/ros.h>
+
+// Other
+#include <gtest/gtest.h>
+
+using cartesian_controller_base::CompactStream;
+
+TEST(TestCompactStream, countGapsInSequenceNumbers)
+{
+  ros::NodeHandle nh("~without_frames");
+  CompactStream stream;
+  ASSERT_TRUE(stream.init(nh,"target_frame_compact","base_link"));
+
+  // The first message may start anywhere
+  const uint32_t sequence[] = {7, 8, 9, 11, 15, 16};
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_TRUE(stream.accept(0,sequence[i]));
+  }
+  EXPECT_EQ(stream.dropped(), 4u);
+
+  // Restarts of the sender and duplicates are no losses
+  EXPECT_TRUE(stream.accept(0,1));
+  EXPECT_TRUE(stream.accept(0,1));
+  EXPECT_TRUE(stream.accept(0,2));
+  EXPECT_EQ(stream.dropped(), 4u);
+
+  // Neither is the wrap-around of the sequence numbers
+  EXPECT_TRUE(stream.accept(0,0xfffffffeu));
+  EXPECT_TRUE(stream.accept(0,0xffffffffu));
+  EXPECT_TRUE(stream.accept(0,0));
+  EXPECT_TRUE(stream.accept(0,2));
+  EXPECT_EQ(stream.dropped(), 5u);
+
+  // Another init starts anew
+  ASSERT_TRUE(stream.init(nh,"target_frame_compact","base_link"));
+  EXPECT_EQ(stream.dropped(), 0u);
+  EXPECT_TRUE(stream.accept(0,100));
+  EXPECT_EQ(stream.dropped(), 0u);
+}
+
+TEST(TestCompactStream, acceptOnlyTheExpectedFrame)
+{
+  std::vector<std::string> frames;
+  frames.push_back("world");
+  frames.push_back("base_link");
+  frames.push_back("tool0");
+  ros::NodeHandle nh("~with_frames");
+  nh.setParam("compact/frames",frames);
+
+  CompactStream stream;
+  EXPECT_FALSE(stream.init(nh,"target_frame_compact","flange"));
+  ASSERT_TRUE(stream.init(nh,"target_frame_compact","base_link"));
+  EXPECT_FALSE(stream.accept(0,1));
+  EXPECT_TRUE(stream.accept(1,2));
+  EXPECT_FALSE(stream.accept(2,3));
+  EXPECT_TRUE(stream.accept(1,4));
+}
+
+TEST(TestCompactStream, convertValues)
+{
+  const float pose[] = {0.1f, -0.2f, 0.3f, 0.0f, 0.0f, 0.70710678f, 0.70710678f};
+  const KDL::Frame frame = CompactStream::toFrame(pose);
+  EXPECT_TRUE(KDL::Equal(frame.p,KDL::Vector(0.1,-0.2,0.3),1.0e-6));
+  EXPECT_TRUE(KDL::Equal(frame.M * KDL::Vector(1,0,0),KDL::Vector(0,1,0),1.0e-6));
+
+  const float values[] = {1.0f, 2.0f, 3.0f, -0.1f, -0.2f, -0.3f};
+  const KDL::Wrench wrench = CompactStream::toWrench(values);
+  EXPECT_TRUE(KDL::Equal(wrench.force,KDL::Vector(1.0,2.0,3.0),1.0e-6));
+  EXPECT_TRUE(KDL::Equal(wrench.torque,KDL::Vector(-0.1,-0.2,-0.3),1.0e-6));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "test_compact_stream");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_cycle_recorder.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/CycleRecorder.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+
+using cartesian_controller_base::CycleRecorder;
+
+namespace
+{
+
+const int NUMBER_JOINTS = 3;
+const int CAPACITY = 4;
+
+//! Records cycles whose values all derive from the cycle's number
+class TestCycleRecorder : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+      positions.assign(NUMBER_JOINTS,0.0);
+      velocities.assign(NUMBER_JOINTS,0.0);
+      efforts.assign(NUMBER_JOINTS,0.0);
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        std::stringstream name;
+        name << "joint" << i + 1;
+        handles.push_back(
+            hardware_interface::JointStateHandle(
+              name.str(),&positions[i],&velocities[i],&efforts[i]));
+      }
+      recorder.init(NUMBER_JOINTS,CAPACITY,"qp",false);
+
+      char filename[] = "/tmp/test_cycle_recorder_XXXXXX";
+      const int fd = ::mkstemp(filename);
+      ::close(fd);
+      file = filename;
+    }
+
+    void TearDown()
+    {
+      std::remove(file.c_str());
+    }
+
+    //! The value of a cycle's field at the given index
+    static double value(int cycle, CycleRecorder::Field field, int index)
+    {
+      return cycle * 1000.0 + field * 10.0 + index;
+    }
+
+    void record(int cycle, double command = 0.0, double torque = 0.0)
+    {
+      KDL::JntArray array(NUMBER_JOINTS);
+      KDL::JntArray other(NUMBER_JOINTS);
+      KDL::JntArray torques(NUMBER_JOINTS);
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        positions[i] = value(cycle,CycleRecorder::JOINT_POSITIONS,i);
+        velocities[i] = value(cycle,CycleRecorder::JOINT_VELOCITIES,i);
+      }
+      recorder.setJointState(handles);
+
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        array(i) = value(cycle,CycleRecorder::SOLVER_POSITIONS,i);
+        other(i) = value(cycle,CycleRecorder::SOLVER_VELOCITIES,i);
+      }
+      recorder.setSolverState(array,other);
+
+      recorder.setTarget(KDL::Frame(KDL::Vector(cycle,0.0,0.0)));
+
+      ctrl::Vector6D wrench;
+      ctrl::Vector6D net_force;
+      for (int i = 0; i < 6; ++i)
+      {
+        wrench[i] = value(cycle,CycleRecorder::WRENCH,i);
+        net_force[i] = value(cycle,CycleRecorder::NET_FORCE,i);
+      }
+      recorder.setWrench(wrench);
+
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        array(i) = value(cycle,CycleRecorder::STEP_POSITIONS,i);
+        other(i) = value(cycle,CycleRecorder::STEP_VELOCITIES,i);
+        torques(i) = value(cycle,CycleRecorder::STEP_EFFORTS,i);
+      }
+      recorder.setFirstStep(ros::Duration(0.001),net_force,array,other,torques);
+
+      KDL::JntArrayVel commands(NUMBER_JOINTS);
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        commands.q(i) = value(cycle,CycleRecorder::CMD_POSITIONS,i) + command;
+        commands.qdot(i) = value(cycle,CycleRecorder::CMD_VELOCITIES,i);
+        torques(i) = value(cycle,CycleRecorder::CMD_EFFORTS,i) + torque;
+      }
+      recorder.finishCycle(cycle,ros::Duration(0.002),10,0.0001,commands,torques);
+    }
+
+    //! Check that the record holds the given cycle
+    void expectCycle(const double* record, int cycle)
+    {
+      SCOPED_TRACE(cycle);
+      const CycleRecorder::Field joint_fields[] = {
+        CycleRecorder::JOINT_POSITIONS, CycleRecorder::JOINT_VELOCITIES,
+        CycleRecorder::SOLVER_POSITIONS, CycleRecorder::SOLVER_VELOCITIES,
+        CycleRecorder::STEP_POSITIONS, CycleRecorder::STEP_VELOCITIES,
+        CycleRecorder::STEP_EFFORTS, CycleRecorder::CMD_POSITIONS,
+        CycleRecorder::CMD_VELOCITIES, CycleRecorder::CMD_EFFORTS};
+      for (int f = 0; f < 10; ++f)
+      {
+        const int offset = CycleRecorder::offset(joint_fields[f],NUMBER_JOINTS);
+        for (int i = 0; i < NUMBER_JOINTS; ++i)
+        {
+          EXPECT_EQ(record[offset + i], value(cycle,joint_fields[f],i));
+        }
+      }
+      for (int i = 0; i < 6; ++i)
+      {
+        EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::WRENCH,NUMBER_JOINTS) + i],
+                  value(cycle,CycleRecorder::WRENCH,i));
+        EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::NET_FORCE,NUMBER_JOINTS) + i],
+                  value(cycle,CycleRecorder::NET_FORCE,i));
+      }
+
+      const double* pose = &record[CycleRecorder::offset(CycleRecorder::TARGET_POSE,NUMBER_JOINTS)];
+      EXPECT_EQ(pose[0], cycle);
+      EXPECT_EQ(pose[1], 0.0);
+      EXPECT_EQ(pose[6], 1.0);
+
+      EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::STAMP,NUMBER_JOINTS)], cycle);
+      EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::PERIOD,NUMBER_JOINTS)], 0.002);
+      EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::INTERNAL_PERIOD,NUMBER_JOINTS)], 0.001);
+      EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::ITERATIONS,NUMBER_JOINTS)], 10.0);
+      EXPECT_EQ(record[CycleRecorder::offset(CycleRecorder::CYCLE_TIME,NUMBER_JOINTS)], 0.0001);
+    }
+
+    std::vector<double> positions;
+    std::vector<double> velocities;
+    std::vector<double> efforts;
+    std::vector<hardware_interface::JointStateHandle> handles;
+    CycleRecorder recorder;
+    std::string file;
+};
+
+} // namespace
+
+TEST_F(TestCycleRecorder, dumpAndLoadLatestCycles)
+{
+  ASSERT_TRUE(recorder.enabled());
+  for (int cycle = 1; cycle <= 5; ++cycle)
+  {
+    record(cycle);
+  }
+  EXPECT_FALSE(recorder.frozen());
+  EXPECT_FALSE(recorder.dump(file));
+
+  // The cycle of the request is the last one in the file
+  recorder.requestDump();
+  record(6);
+  EXPECT_TRUE(recorder.frozen());
+  record(7);
+  ASSERT_TRUE(recorder.dump(file));
+  EXPECT_FALSE(recorder.frozen());
+
+  CycleRecorder::FileHeader header;
+  std::vector<double> records;
+  ASSERT_TRUE(CycleRecorder::load(file,header,records));
+  EXPECT_EQ(header.number_joints, static_cast<uint32_t>(NUMBER_JOINTS));
+  EXPECT_EQ(header.record_size,
+            static_cast<uint32_t>(CycleRecorder::offset(CycleRecorder::NUMBER_FIELDS,NUMBER_JOINTS)));
+  EXPECT_EQ(header.number_records, static_cast<uint64_t>(CAPACITY));
+  EXPECT_EQ(std::string(header.solver_type), "qp");
+  EXPECT_EQ(header.joint_efforts, 0u);
+  ASSERT_EQ(records.size(), static_cast<size_t>(CAPACITY * header.record_size));
+  for (int r = 0; r < CAPACITY; ++r)
+  {
+    expectCycle(&records[r * header.record_size],3 + r);
+  }
+
+  // Recording starts anew after a dump
+  record(8);
+  recorder.requestDump();
+  record(9);
+  ASSERT_TRUE(recorder.dump(file));
+  ASSERT_TRUE(CycleRecorder::load(file,header,records));
+  ASSERT_EQ(header.number_records, 2u);
+  expectCycle(&records[0],8);
+  expectCycle(&records[header.record_size],9);
+}
+
+TEST_F(TestCycleRecorder, freezeOnInvalidCommands)
+{
+  record(1);
+  record(2,std::numeric_limits<double>::quiet_NaN());
+  EXPECT_TRUE(recorder.frozen());
+  record(3);
+  ASSERT_TRUE(recorder.dump(file));
+
+  CycleRecorder::FileHeader header;
+  std::vector<double> records;
+  ASSERT_TRUE(CycleRecorder::load(file,header,records));
+  ASSERT_EQ(header.number_records, 2u);
+  expectCycle(&records[0],1);
+
+  // The faulty cycle comes last
+  const double* faulty = &records[header.record_size];
+  EXPECT_EQ(faulty[CycleRecorder::offset(CycleRecorder::STAMP,NUMBER_JOINTS)], 2.0);
+  EXPECT_TRUE(std::isnan(faulty[CycleRecorder::offset(CycleRecorder::CMD_POSITIONS,NUMBER_JOINTS)]));
+}
+
+TEST_F(TestCycleRecorder, freezeOnInvalidTorques)
+{
+  recorder.init(NUMBER_JOINTS,CAPACITY,"forward_dynamics",true);
+  record(1);
+  record(2,0.0,std::numeric_limits<double>::infinity());
+  EXPECT_TRUE(recorder.frozen());
+  ASSERT_TRUE(recorder.dump(file));
+
+  CycleRecorder::FileHeader header;
+  std::vector<double> records;
+  ASSERT_TRUE(CycleRecorder::load(file,header,records));
+  EXPECT_NE(header.joint_efforts, 0u);
+  ASSERT_EQ(header.number_records, 2u);
+  expectCycle(&records[0],1);
+  const double* faulty = &records[header.record_size];
+  EXPECT_TRUE(std::isinf(faulty[CycleRecorder::offset(CycleRecorder::CMD_EFFORTS,NUMBER_JOINTS)]));
+}
+
+TEST_F(TestCycleRecorder, rejectOtherFiles)
+{
+  std::ofstream(file.c_str()) << "Not a recording of control cycles";
+  CycleRecorder::FileHeader header;
+  std::vector<double> records;
+  EXPECT_FALSE(CycleRecorder::load(file,header,records));
+  EXPECT_FALSE(CycleRecorder::load(file + ".missing",header,records));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
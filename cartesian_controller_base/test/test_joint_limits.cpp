@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_joint_limits.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/IKSolver.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <boost/scoped_ptr.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_JOINTS = 6;
+const double PERIOD = 0.002;
+const double MAX_VELOCITY = 0.5;
+const double MAX_ACCELERATION = 5.0;
+
+//! A serial chain of uniform links with alternating joint axes
+KDL::Chain buildChain()
+{
+  KDL::Chain chain;
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    std::stringstream name;
+    name << "link" << i + 1;
+    chain.addSegment(
+        KDL::Segment(
+          name.str(),
+          KDL::Joint(i % 2 ? KDL::Joint::RotY : KDL::Joint::RotZ),
+          KDL::Frame(KDL::Vector(0.0,0.05,0.3)),
+          KDL::RigidBodyInertia(1.0,KDL::Vector(0.0,0.0,0.15),KDL::RotationalInertia::Zero())));
+  }
+  return chain;
+}
+
+//! A solver at a bent joint configuration with the test's motion limits
+class TestJointLimits : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+      positions.assign(NUMBER_JOINTS,0.5);
+      velocities.assign(NUMBER_JOINTS,0.0);
+      efforts.assign(NUMBER_JOINTS,0.0);
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        std::stringstream name;
+        name << "joint" << i + 1;
+        handles.push_back(
+            hardware_interface::JointStateHandle(
+              name.str(),&positions[i],&velocities[i],&efforts[i]));
+      }
+
+      KDL::JntArray upper(NUMBER_JOINTS);
+      KDL::JntArray lower(NUMBER_JOINTS);
+      KDL::JntArray max_velocities(NUMBER_JOINTS);
+      KDL::JntArray max_accelerations(NUMBER_JOINTS);
+      for (int i = 0; i < NUMBER_JOINTS; ++i)
+      {
+        upper(i) = 3.14;
+        lower(i) = -3.14;
+        max_velocities(i) = MAX_VELOCITY;
+        max_accelerations(i) = MAX_ACCELERATION;
+      }
+      solver.reset(cartesian_controller_base::IKSolver::create("forward_dynamics"));
+      solver->init(buildChain(),upper,lower);
+      solver->setMotionLimits(max_velocities,max_accelerations);
+      solver->setStartState(handles);
+      solver->updateKinematics<hardware_interface::PositionJointInterface>(handles);
+    }
+
+    std::vector<double> positions;
+    std::vector<double> velocities;
+    std::vector<double> efforts;
+    std::vector<hardware_interface::JointStateHandle> handles;
+    boost::scoped_ptr<cartesian_controller_base::IKSolver> solver;
+};
+
+} // namespace
+
+TEST_F(TestJointLimits, limitEachCycleOfPositionCommands)
+{
+  // Start at rest where the robot is
+  KDL::JntArray last_positions = solver->getPositions();
+  KDL::JntArray last_velocities(NUMBER_JOINTS);
+  KDL::JntArray cmd_positions(NUMBER_JOINTS);
+  KDL::JntArray cmd_velocities(NUMBER_JOINTS);
+
+  // A far target. Unlimited, each cycle's iterations move much further
+  // than the velocity limits allow within one period.
+  const KDL::Vector target = solver->getEndEffectorPose().p + KDL::Vector(0.5,-0.3,-0.4);
+  const double start_error = (target - solver->getEndEffectorPose().p).Norm();
+  bool limited = false;
+  for (int cycle = 0; cycle < 500; ++cycle)
+  {
+    for (int iteration = 0; iteration < 10; ++iteration)
+    {
+      const KDL::Vector error = target - solver->getEndEffectorPose().p;
+      ctrl::Vector6D net_force;
+      net_force << error.x(), error.y(), error.z(), 0.0, 0.0, 0.0;
+      net_force *= 5000.0;
+      solver->getJointControlCmds(ros::Duration(0.02),net_force,cmd_positions,cmd_velocities);
+      solver->updateKinematics<hardware_interface::PositionJointInterface>(handles);
+    }
+
+    if (solver->limitPositionCommands(
+          last_positions,last_velocities,ros::Duration(PERIOD),cmd_positions,cmd_velocities))
+    {
+      solver->setPositions(cmd_positions);
+      limited = true;
+    }
+
+    for (int i = 0; i < NUMBER_JOINTS; ++i)
+    {
+      SCOPED_TRACE(cycle);
+      EXPECT_LE(std::abs(cmd_positions(i) - last_positions(i)),MAX_VELOCITY * PERIOD + 1.0e-12);
+      EXPECT_LE(std::abs(cmd_velocities(i) - last_velocities(i)),MAX_ACCELERATION * PERIOD + 1.0e-9);
+      EXPECT_NEAR(cmd_velocities(i) * PERIOD,cmd_positions(i) - last_positions(i),1.0e-12);
+      EXPECT_EQ(solver->getPositions()(i),cmd_positions(i));
+    }
+    last_positions = cmd_positions;
+    last_velocities = cmd_velocities;
+  }
+  EXPECT_TRUE(limited);
+
+  // Still heading for the target
+  EXPECT_LT((target - solver->getEndEffectorPose().p).Norm(),start_error);
+}
+
+TEST_F(TestJointLimits, keepDirectionOfPositionCommands)
+{
+  // A step at twice the velocity limit for some joints. The last
+  // velocities allow to scale it down to half within the acceleration limits.
+  KDL::JntArray last_positions = solver->getPositions();
+  KDL::JntArray last_velocities(NUMBER_JOINTS);
+  KDL::JntArray cmd_positions = last_positions;
+  KDL::JntArray cmd_velocities(NUMBER_JOINTS);
+  KDL::JntArray step(NUMBER_JOINTS);
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    step(i) = (i % 2 ? 1.0 : 2.0) * MAX_VELOCITY * PERIOD;
+    cmd_positions(i) += step(i);
+    last_velocities(i) = 0.5 * step(i) / PERIOD;
+  }
+
+  ASSERT_TRUE(solver->limitPositionCommands(
+        last_positions,last_velocities,ros::Duration(PERIOD),cmd_positions,cmd_velocities));
+
+  // One common scale for all joints
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    EXPECT_NEAR(cmd_positions(i) - last_positions(i),0.5 * step(i),1.0e-12);
+    EXPECT_NEAR(cmd_velocities(i),0.5 * step(i) / PERIOD,1.0e-9);
+  }
+}
+
+TEST_F(TestJointLimits, limitVelocityCommands)
+{
+  KDL::JntArray last_velocities(NUMBER_JOINTS);
+  KDL::JntArray cmd_velocities(NUMBER_JOINTS);
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    cmd_velocities(i) = i % 2 ? 2.0 : -2.0;
+  }
+
+  // Accelerate from rest and keep on
+  for (int cycle = 0; cycle < 200; ++cycle)
+  {
+    KDL::JntArray limited = cmd_velocities;
+    solver->limitVelocityCommands(last_velocities,ros::Duration(PERIOD),limited);
+    for (int i = 0; i < NUMBER_JOINTS; ++i)
+    {
+      SCOPED_TRACE(cycle);
+      EXPECT_LE(std::abs(limited(i)),MAX_VELOCITY + 1.0e-12);
+      EXPECT_LE(std::abs(limited(i) - last_velocities(i)),MAX_ACCELERATION * PERIOD + 1.0e-12);
+    }
+    last_velocities = limited;
+  }
+
+  // Reaches the velocity limit in the commanded direction
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    EXPECT_NEAR(last_velocities(i),i % 2 ? MAX_VELOCITY : -MAX_VELOCITY,1.0e-9);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
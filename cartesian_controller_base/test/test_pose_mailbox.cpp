@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_pose_mailbox.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/PoseMailbox.h>
+
+// Other
+#include <gtest/gtest.h>
+
+using cartesian_controller_base::PoseMailbox;
+
+namespace
+{
+
+//! A pose whose components all encode the same number
+KDL::Frame encode(double value)
+{
+  return KDL::Frame(
+      KDL::Rotation::RPY(value,value,value),
+      KDL::Vector(value,value,value));
+}
+
+//! Whether all components of the pose encode the same number
+bool isConsistent(const KDL::Frame& frame, double value)
+{
+  return KDL::Equal(frame,encode(value),1e-12);
+}
+
+} // namespace
+
+TEST(TestPoseMailbox, shareMailboxesPerTopicAndFrame)
+{
+  PoseMailbox::Ptr mailbox = PoseMailbox::get("/target_frame","base_link");
+  EXPECT_EQ(mailbox, PoseMailbox::get("/target_frame","base_link"));
+  EXPECT_NE(mailbox, PoseMailbox::get("/target_frame","world"));
+  EXPECT_NE(mailbox, PoseMailbox::get("/other_frame","base_link"));
+}
+
+TEST(TestPoseMailbox, readEachPoseOnce)
+{
+  PoseMailbox mailbox;
+  KDL::Frame frame;
+  ros::Time stamp;
+  unsigned long sequence = mailbox.sequence();
+  EXPECT_EQ(sequence, 0u);
+  EXPECT_FALSE(mailbox.read(frame,stamp,sequence));
+  EXPECT_FALSE(mailbox.isActive(ros::Time(1.0),ros::Duration(0.1)));
+
+  mailbox.write(encode(0.1),ros::Time(1.0));
+  EXPECT_TRUE(mailbox.read(frame,stamp,sequence));
+  EXPECT_TRUE(isConsistent(frame,0.1));
+  EXPECT_EQ(stamp, ros::Time(1.0));
+  EXPECT_EQ(sequence, mailbox.sequence());
+  EXPECT_FALSE(mailbox.read(frame,stamp,sequence));
+
+  // Only the latest pose is kept
+  mailbox.write(encode(0.2),ros::Time(2.0));
+  mailbox.write(encode(0.3),ros::Time(3.0));
+  EXPECT_TRUE(mailbox.read(frame,stamp,sequence));
+  EXPECT_TRUE(isConsistent(frame,0.3));
+  EXPECT_EQ(stamp, ros::Time(3.0));
+
+  EXPECT_TRUE(mailbox.isActive(ros::Time(3.05),ros::Duration(0.1)));
+  EXPECT_FALSE(mailbox.isActive(ros::Time(3.2),ros::Duration(0.1)));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_qp_solver.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/QPSolver.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+
+const int NUMBER_JOINTS = 6;
+const double PERIOD = 0.01;
+const double DAMPING = 0.05;
+const double TOLERANCE = 1.0e-6;
+
+//! A serial chain of uniform links with alternating joint axes
+KDL::Chain buildChain()
+{
+  KDL::Chain chain;
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    std::stringstream name;
+    name << "link" << i + 1;
+    chain.addSegment(
+        KDL::Segment(
+          name.str(),
+          KDL::Joint(i % 2 ? KDL::Joint::RotY : KDL::Joint::RotZ),
+          KDL::Frame(KDL::Vector(0.0,0.05,0.3))));
+  }
+  return chain;
+}
+
+//! Joint arrays with the same value per joint
+KDL::JntArray uniform(double value)
+{
+  KDL::JntArray array(NUMBER_JOINTS);
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    array(i) = value;
+  }
+  return array;
+}
+
+//! A Cartesian velocity that moves all joints
+ctrl::Vector6D cartesianVelocity()
+{
+  ctrl::Vector6D velocity;
+  velocity << 0.3, -0.2, 0.4, 0.5, -0.3, 0.2;
+  return velocity;
+}
+
+//! Joint velocities of one solver step from the given joint positions
+KDL::JntArray solve(
+    cartesian_controller_base::IKSolver& solver,
+    const KDL::JntArray& positions)
+{
+  KDL::JntArray commanded(NUMBER_JOINTS);
+  KDL::JntArray velocities(NUMBER_JOINTS);
+  solver.setPositions(positions);
+  solver.getJointControlCmds(ros::Duration(PERIOD),cartesianVelocity(),commanded,velocities);
+  return velocities;
+}
+
+} // namespace
+
+TEST(TestQPSolver, matchDampedLeastSquaresWithinLimits)
+{
+  cartesian_controller_base::QPSolver qp;
+  cartesian_controller_base::DampedLeastSquaresSolver dls;
+  ASSERT_TRUE(qp.init(buildChain(),uniform(3.14),uniform(-3.14)));
+  ASSERT_TRUE(dls.init(buildChain(),uniform(3.14),uniform(-3.14)));
+  qp.setDamping(DAMPING);
+  dls.setDamping(DAMPING);
+
+  const KDL::JntArray expected = solve(dls,uniform(0.5));
+  const KDL::JntArray velocities = solve(qp,uniform(0.5));
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    EXPECT_NEAR(velocities(i), expected(i), TOLERANCE);
+  }
+}
+
+TEST(TestQPSolver, findOptimumWithActiveLimits)
+{
+  // Limit the first joints to half of their unconstrained motion
+  cartesian_controller_base::DampedLeastSquaresSolver dls;
+  ASSERT_TRUE(dls.init(buildChain(),uniform(3.14),uniform(-3.14)));
+  dls.setDamping(DAMPING);
+  const KDL::JntArray positions = uniform(0.5);
+  const KDL::JntArray unconstrained = solve(dls,positions);
+
+  KDL::JntArray upper = uniform(3.14);
+  KDL::JntArray lower = uniform(-3.14);
+  for (int i = 0; i < 3; ++i)
+  {
+    const double margin = 0.5 * unconstrained(i) * PERIOD;
+    if (margin > 0.0)
+    {
+      upper(i) = positions(i) + margin;
+    }
+    else
+    {
+      lower(i) = positions(i) + margin;
+    }
+  }
+
+  cartesian_controller_base::QPSolver qp;
+  ASSERT_TRUE(qp.init(buildChain(),upper,lower));
+  qp.setDamping(DAMPING);
+  qp.setPositions(positions);
+  const ctrl::MatrixND jacobian = qp.getJacobian().data;
+  const KDL::JntArray velocities = solve(qp,positions);
+
+  // Karush-Kuhn-Tucker conditions of
+  // min 1/2 |J dq - dx|^2 + 1/2 damping^2 |dq|^2 within the velocity box
+  const ctrl::VectorND gradient =
+    jacobian.transpose() * (jacobian * velocities.data - cartesianVelocity()) +
+    DAMPING * DAMPING * velocities.data;
+  int active = 0;
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    SCOPED_TRACE(i);
+    const double min_velocity = (lower(i) - positions(i)) / PERIOD;
+    const double max_velocity = (upper(i) - positions(i)) / PERIOD;
+    EXPECT_GE(velocities(i), min_velocity - TOLERANCE);
+    EXPECT_LE(velocities(i), max_velocity + TOLERANCE);
+
+    if (std::abs(velocities(i) - max_velocity) < TOLERANCE)
+    {
+      EXPECT_LE(gradient(i), TOLERANCE);
+      ++active;
+    }
+    else if (std::abs(velocities(i) - min_velocity) < TOLERANCE)
+    {
+      EXPECT_GE(gradient(i), -TOLERANCE);
+      ++active;
+    }
+    else
+    {
+      EXPECT_NEAR(gradient(i), 0.0, TOLERANCE);
+    }
+  }
+  EXPECT_GT(active, 0);
+}
+
+TEST(TestQPSolver, onlyMoveBackFromBeyondLimits)
+{
+  cartesian_controller_base::QPSolver qp;
+  ASSERT_TRUE(qp.init(buildChain(),uniform(0.4),uniform(-3.14)));
+  qp.setDamping(DAMPING);
+
+  const KDL::JntArray velocities = solve(qp,uniform(0.5));
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    EXPECT_LE(velocities(i), TOLERANCE);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_seq_lock.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/SeqLock.h>
+
+// KDL
+#include <kdl/jntarray.hpp>
+
+// Other
+#include <gtest/gtest.h>
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
+using cartesian_controller_base::SeqLock;
+
+namespace
+{
+
+const int NUMBER_JOINTS = 7;
+
+//! Joint values that all encode the same number
+KDL::JntArray encode(double value)
+{
+  KDL::JntArray array(NUMBER_JOINTS);
+  for (int i = 0; i < NUMBER_JOINTS; ++i)
+  {
+    array(i) = value;
+  }
+  return array;
+}
+
+//! Whether all joint values encode the same number
+bool isConsistent(const KDL::JntArray& array)
+{
+  for (int i = 1; i < NUMBER_JOINTS; ++i)
+  {
+    if (array(i) != array(0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(TestSeqLock, readEachValueOnce)
+{
+  SeqLock<KDL::JntArray> lock;
+  lock.init(encode(0.0));
+
+  KDL::JntArray value = encode(-1.0);
+  KDL::JntArray scratch(NUMBER_JOINTS);
+  unsigned long sequence = lock.sequence();
+  EXPECT_EQ(sequence, 0u);
+  EXPECT_FALSE(lock.read(value,sequence,scratch));
+  EXPECT_EQ(value(0), -1.0);
+
+  EXPECT_TRUE(lock.write(encode(1.0)));
+  EXPECT_TRUE(lock.read(value,sequence,scratch));
+  EXPECT_EQ(value(0), 1.0);
+  EXPECT_EQ(sequence, lock.sequence());
+  EXPECT_TRUE(isConsistent(value));
+  EXPECT_FALSE(lock.read(value,sequence,scratch));
+
+  // Only the latest value is kept
+  lock.write(encode(2.0));
+  lock.write(encode(3.0));
+  EXPECT_TRUE(lock.read(value,sequence,scratch));
+  EXPECT_EQ(value(0), 3.0);
+  EXPECT_FALSE(lock.read(value,sequence,scratch));
+}
+
+TEST(TestSeqLock, neverReadTornValues)
+{
+  SeqLock<KDL::JntArray> lock;
+  lock.init(encode(0.0));
+  boost::atomic<bool> done(false);
+  const int writes = 200000;
+
+  boost::thread writer([&]()
+      {
+        for (int i = 1; i <= writes; ++i)
+        {
+          lock.write(encode(i));
+        }
+        done = true;
+      });
+
+  KDL::JntArray value(NUMBER_JOINTS);
+  KDL::JntArray scratch(NUMBER_JOINTS);
+  unsigned long sequence = 0;
+  int reads = 0;
+  double last_write = 0.0;
+  while (true)
+  {
+    const bool finished = done;
+    if (!lock.read(value,sequence,scratch))
+    {
+      if (finished)
+      {
+        break;
+      }
+      continue;
+    }
+    ASSERT_TRUE(isConsistent(value)) << "Torn read of write " << value(0);
+    EXPECT_GT(value(0), last_write);
+    last_write = value(0);
+    ++reads;
+  }
+  writer.join();
+
+  EXPECT_GT(reads, 0);
+  EXPECT_EQ(last_write, static_cast<double>(writes));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
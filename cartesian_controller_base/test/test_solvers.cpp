@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_solvers.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/IKSolver.h>
+#include <cartesian_controller_base/DampedLeastSquaresSolver.h>
+
+// KDL
+#include <kdl/chainfksolverpos_recursive.hpp>
+#include <kdl/chainjnttojacsolver.hpp>
+#include <kdl/chaindynparam.hpp>
+
+// Other
+#include <gtest/gtest.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//! A serial chain of uniform links with alternating joint axes
+KDL::Chain buildChain(int number_joints)
+{
+  KDL::Chain chain;
+  for (int i = 0; i < number_joints; ++i)
+  {
+    std::stringstream name;
+    name << "link" << i + 1;
+    chain.addSegment(
+        KDL::Segment(
+          name.str(),
+          KDL::Joint(i % 2 ? KDL::Joint::RotY : KDL::Joint::RotZ),
+          KDL::Frame(KDL::Rotation::RPY(0.0,0.0,0.1 * i),KDL::Vector(0.0,0.05,0.3)),
+          KDL::RigidBodyInertia(1.0,KDL::Vector(0.0,0.0,0.15),KDL::RotationalInertia::Zero())));
+  }
+  chain.addSegment(
+      KDL::Segment("tool0",KDL::Joint(KDL::Joint::None),KDL::Frame(KDL::Vector(0.0,0.0,0.1))));
+  return chain;
+}
+
+//! A chain with all joint axes, full link inertias and a fixed flange in the middle
+KDL::Chain buildInertialChain(int number_joints)
+{
+  const KDL::Joint::JointType axes[] = {KDL::Joint::RotZ, KDL::Joint::RotY, KDL::Joint::RotX};
+  KDL::Chain chain;
+  for (int i = 0; i < number_joints; ++i)
+  {
+    std::stringstream name;
+    name << "link" << i + 1;
+    chain.addSegment(
+        KDL::Segment(
+          name.str(),
+          KDL::Joint(axes[i % 3]),
+          KDL::Frame(KDL::Rotation::RPY(0.2,-0.1,0.3 * i),KDL::Vector(0.02,0.05,0.3)),
+          KDL::RigidBodyInertia(
+            1.0 + 0.1 * i,
+            KDL::Vector(0.01,-0.02,0.15),
+            KDL::RotationalInertia(0.02,0.03,0.01,0.001,-0.002,0.003))));
+    if (i == number_joints / 2)
+    {
+      chain.addSegment(
+          KDL::Segment(
+            "flange",
+            KDL::Joint(KDL::Joint::None),
+            KDL::Frame(KDL::Rotation::RotX(0.5),KDL::Vector(0.0,0.0,0.05)),
+            KDL::RigidBodyInertia(0.5,KDL::Vector(0.0,0.03,0.0),KDL::RotationalInertia(0.01,0.01,0.01))));
+    }
+  }
+  chain.addSegment(
+      KDL::Segment("tool0",KDL::Joint(KDL::Joint::None),KDL::Frame(KDL::Vector(0.0,0.0,0.1))));
+  return chain;
+}
+
+//! Exposes the solvers' fused kinematics pass
+class KinematicsProbe : public cartesian_controller_base::DampedLeastSquaresSolver
+{
+  public:
+    using IKSolver::computeKinematics;
+};
+
+//! Joint state of a bent robot at rest
+struct Robot
+{
+  Robot(int number_joints)
+    : positions(number_joints, 0.5)
+    , velocities(number_joints, 0.0)
+    , efforts(number_joints, 0.0)
+  {
+    for (int i = 0; i < number_joints; ++i)
+    {
+      std::stringstream name;
+      name << "joint" << i + 1;
+      handles.push_back(
+          hardware_interface::JointStateHandle(
+            name.str(),&positions[i],&velocities[i],&efforts[i]));
+    }
+  }
+
+  std::vector<double> positions;
+  std::vector<double> velocities;
+  std::vector<double> efforts;
+  std::vector<hardware_interface::JointStateHandle> handles;
+};
+
+} // namespace
+
+TEST(TestSolvers, reachCartesianTarget)
+{
+  // Forward dynamics takes forces on its virtual masses, the others
+  // Cartesian velocities
+  const char* types[] = {"forward_dynamics", "damped_least_squares", "qp"};
+  const double gains[] = {2000.0, 10.0, 10.0};
+  const KDL::Chain chain = buildChain(6);
+
+  for (int t = 0; t < 3; ++t)
+  {
+    SCOPED_TRACE(types[t]);
+    boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+        cartesian_controller_base::IKSolver::create(types[t]));
+    ASSERT_TRUE(solver);
+
+    KDL::JntArray upper(6);
+    KDL::JntArray lower(6);
+    for (int i = 0; i < 6; ++i)
+    {
+      upper(i) = 3.14;
+      lower(i) = -3.14;
+    }
+    Robot robot(6);
+    ASSERT_TRUE(solver->init(chain,upper,lower));
+    solver->setStartState(robot.handles);
+    solver->updateKinematics<hardware_interface::PositionJointInterface>(robot.handles);
+
+    // Pull the end effector towards a nearby target in the feed forward
+    // simulation of the motion controller
+    const KDL::Vector target = solver->getEndEffectorPose().p + KDL::Vector(0.03,-0.02,0.04);
+    const double start_error = (target - solver->getEndEffectorPose().p).Norm();
+    KDL::JntArray positions(6);
+    KDL::JntArray velocities(6);
+    for (int step = 0; step < 1000; ++step)
+    {
+      const KDL::Vector error = target - solver->getEndEffectorPose().p;
+      ctrl::Vector6D net_force;
+      net_force << error.x(), error.y(), error.z(), 0.0, 0.0, 0.0;
+      net_force *= gains[t];
+      solver->getJointControlCmds(ros::Duration(0.02),net_force,positions,velocities);
+      solver->updateKinematics<hardware_interface::PositionJointInterface>(robot.handles);
+    }
+
+    const double error = (target - solver->getEndEffectorPose().p).Norm();
+    EXPECT_LT(error,1.0e-2 * start_error);
+  }
+}
+
+TEST(TestSolvers, resumeHandedOverState)
+{
+  const KDL::Chain chain = buildChain(6);
+  KDL::JntArray upper(6);
+  KDL::JntArray lower(6);
+  for (int i = 0; i < 6; ++i)
+  {
+    upper(i) = 3.14;
+    lower(i) = -3.14;
+  }
+
+  // A standby solver prepared at a slightly different joint state
+  Robot sample(6);
+  Robot robot(6);
+  for (int i = 0; i < 6; ++i)
+  {
+    robot.positions[i] += 1.0e-4 * (i + 1);
+    robot.velocities[i] = 0.01;
+  }
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> standby(
+      cartesian_controller_base::IKSolver::create("forward_dynamics"));
+  ASSERT_TRUE(standby->init(chain,upper,lower));
+  standby->setStartState(sample.handles);
+  standby->updateKinematics<hardware_interface::PositionJointInterface>(sample.handles);
+  const ctrl::MatrixND standby_jacobian = standby->getJacobian().data;
+
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> solver(
+      cartesian_controller_base::IKSolver::create("forward_dynamics"));
+  ASSERT_TRUE(solver->init(chain,upper,lower));
+  solver->swapState(*standby);
+  solver->resumeState(robot.handles);
+
+  // Joint state and frames are those of the robot
+  boost::scoped_ptr<cartesian_controller_base::IKSolver> reference(
+      cartesian_controller_base::IKSolver::create("forward_dynamics"));
+  ASSERT_TRUE(reference->init(chain,upper,lower));
+  reference->setStartState(robot.handles);
+  reference->updateKinematics<hardware_interface::PositionJointInterface>(robot.handles);
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(solver->getPositions()(i), robot.positions[i]);
+    EXPECT_EQ(solver->getVelocities()(i), robot.velocities[i]);
+  }
+  EXPECT_TRUE(KDL::Equal(solver->getEndEffectorPose(),reference->getEndEffectorPose(),1.0e-12));
+
+  // The Jacobian of the standby sample is kept
+  EXPECT_TRUE(solver->getJacobian().data == standby_jacobian);
+  EXPECT_FALSE(reference->getJacobian().data.isApprox(standby_jacobian,1.0e-9));
+}
+
+TEST(TestSolvers, matchKdlKinematics)
+{
+  // Fused segment frames, Jacobian and joint space inertia in one pass
+  // against the separate KDL solvers
+  boost::random::mt19937 generator(42);
+  boost::random::uniform_real_distribution<double> random_position(-3.0,3.0);
+  const int chains[] = {6, 7, 12};
+
+  for (int c = 0; c < 3; ++c)
+  {
+    const int n = chains[c];
+    SCOPED_TRACE(n);
+    const KDL::Chain chain = buildInertialChain(n);
+    KDL::JntArray upper(n);
+    KDL::JntArray lower(n);
+    for (int i = 0; i < n; ++i)
+    {
+      upper(i) = 3.14;
+      lower(i) = -3.14;
+    }
+    KinematicsProbe solver;
+    ASSERT_TRUE(solver.init(chain,upper,lower));
+
+    KDL::ChainFkSolverPos_recursive fk_solver(chain);
+    KDL::ChainJntToJacSolver jac_solver(chain);
+    KDL::ChainDynParam dyn_param(chain,KDL::Vector::Zero());
+
+    for (int sample = 0; sample < 20; ++sample)
+    {
+      KDL::JntArray q(n);
+      for (int i = 0; i < n; ++i)
+      {
+        q(i) = random_position(generator);
+      }
+      solver.setPositions(q);
+      KDL::JntSpaceInertiaMatrix inertia(n);
+      solver.computeKinematics(&inertia);
+
+      const std::vector<KDL::Frame>& frames = solver.getSegmentFrames();
+      ASSERT_EQ(frames.size(), chain.getNrOfSegments());
+      for (size_t s = 0; s < frames.size(); ++s)
+      {
+        KDL::Frame frame;
+        fk_solver.JntToCart(q,frame,s + 1);
+        EXPECT_TRUE(KDL::Equal(frames[s],frame,1.0e-12)) << "Segment " << s;
+      }
+      EXPECT_TRUE(KDL::Equal(solver.getEndEffectorPose(),frames.back(),1.0e-12));
+
+      KDL::Jacobian jacobian(n);
+      jac_solver.JntToJac(q,jacobian);
+      EXPECT_TRUE(solver.getJacobian().data.isApprox(jacobian.data,1.0e-12));
+
+      KDL::JntSpaceInertiaMatrix reference(n);
+      dyn_param.JntToMass(q,reference);
+      EXPECT_TRUE(inertia.data.isApprox(reference.data,1.0e-12))
+        << "Fused:\n" << inertia.data << "\nKDL:\n" << reference.data;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_tool_identification.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/ToolIdentification.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <Eigen/Geometry>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <cmath>
+
+using cartesian_controller_base::ToolIdentification;
+
+namespace
+{
+
+//! A tool on a force-torque sensor with offsets
+struct Tool
+{
+  Tool(double m, const ctrl::Vector3D& c)
+    : mass(m)
+    , center_of_mass(c)
+  {
+    force_offset << 2.0, -1.5, 0.7;
+    torque_offset << 0.05, 0.1, -0.08;
+  }
+
+  //! The sensor's measurement for the given gravity in the sensor frame
+  ctrl::Vector6D measure(const ctrl::Vector3D& gravity) const
+  {
+    ctrl::Vector6D wrench;
+    wrench.head<3>() = mass * gravity + force_offset;
+    wrench.tail<3>() = center_of_mass.cross(mass * gravity) + torque_offset;
+    return wrench;
+  }
+
+  double mass;
+  ctrl::Vector3D center_of_mass;
+  ctrl::Vector3D force_offset;
+  ctrl::Vector3D torque_offset;
+};
+
+//! Gravity in the sensor frame for the i-th of a set of different orientations
+ctrl::Vector3D gravity(int i)
+{
+  const Eigen::Matrix3d orientation(
+      Eigen::AngleAxisd(0.7 * i,ctrl::Vector3D::UnitZ()) *
+      Eigen::AngleAxisd(0.4 * std::sin(1.3 * i),ctrl::Vector3D::UnitY()) *
+      Eigen::AngleAxisd(0.9 * std::cos(0.5 * i),ctrl::Vector3D::UnitX()));
+  return orientation.transpose() * ctrl::Vector3D(0.0,0.0,-9.81);
+}
+
+} // namespace
+
+TEST(TestToolIdentification, identifyToolFromDifferentOrientations)
+{
+  const Tool tool(1.7,ctrl::Vector3D(0.01,-0.02,0.08));
+  ToolIdentification identification;
+  EXPECT_FALSE(identification.converged());
+
+  for (int i = 0; i < 50; ++i)
+  {
+    identification.update(gravity(i),tool.measure(gravity(i)));
+  }
+  EXPECT_EQ(identification.samples(), 50u);
+  EXPECT_TRUE(identification.converged());
+
+  // Only the finite initial covariance keeps the estimate from being exact
+  EXPECT_NEAR(identification.mass(), tool.mass, 1.0e-4);
+  EXPECT_LT((identification.centerOfMass() - tool.center_of_mass).norm(), 1.0e-4);
+
+  identification.reset();
+  EXPECT_EQ(identification.samples(), 0u);
+  EXPECT_FALSE(identification.converged());
+}
+
+TEST(TestToolIdentification, needDifferentOrientations)
+{
+  // Offsets and weight can't be told apart in a single orientation
+  const Tool tool(1.7,ctrl::Vector3D(0.01,-0.02,0.08));
+  ToolIdentification identification;
+  for (int i = 0; i < 50; ++i)
+  {
+    identification.update(gravity(0),tool.measure(gravity(0)));
+  }
+  EXPECT_FALSE(identification.converged());
+}
+
+TEST(TestToolIdentification, averageSensorNoise)
+{
+  const Tool tool(0.8,ctrl::Vector3D(-0.03,0.0,0.05));
+  ToolIdentification identification;
+  boost::random::mt19937 generator(42);
+  boost::random::normal_distribution<double> force_noise(0.0,0.1);
+  boost::random::normal_distribution<double> torque_noise(0.0,0.005);
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    ctrl::Vector6D wrench = tool.measure(gravity(i));
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      wrench[axis] += force_noise(generator);
+      wrench[axis + 3] += torque_noise(generator);
+    }
+    identification.update(gravity(i),wrench);
+  }
+  EXPECT_TRUE(identification.converged());
+  EXPECT_NEAR(identification.mass(), tool.mass, 0.01);
+  EXPECT_LT((identification.centerOfMass() - tool.center_of_mass).norm(), 0.005);
+}
+
+TEST(TestToolIdentification, followToolChangesWhenForgetting)
+{
+  const Tool first(1.7,ctrl::Vector3D(0.01,-0.02,0.08));
+  const Tool second(0.5,ctrl::Vector3D(0.0,0.04,0.12));
+  ToolIdentification identification(0.95);
+
+  for (int i = 0; i < 200; ++i)
+  {
+    identification.update(gravity(i),first.measure(gravity(i)));
+  }
+  EXPECT_NEAR(identification.mass(), first.mass, 1.0e-4);
+
+  for (int i = 200; i < 600; ++i)
+  {
+    identification.update(gravity(i),second.measure(gravity(i)));
+  }
+  EXPECT_NEAR(identification.mass(), second.mass, 1.0e-3);
+  EXPECT_LT((identification.centerOfMass() - second.center_of_mass).norm(), 1.0e-3);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
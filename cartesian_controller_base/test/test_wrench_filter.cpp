@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_wrench_filter.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_controller_base/WrenchFilter.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using cartesian_controller_base::WrenchFilter;
+
+namespace
+{
+
+//! A wrench with the same value on all axes
+ctrl::Vector6D uniform(double value)
+{
+  return ctrl::Vector6D::Constant(value);
+}
+
+//! Largest absolute output of a sinusoid's last period after settling
+double amplitude(WrenchFilter& filter, double frequency, double sample_rate)
+{
+  const int samples = static_cast<int>(sample_rate / frequency);
+  double amplitude = 0.0;
+  for (int i = 0; i < 20 * samples; ++i)
+  {
+    const double output = filter(uniform(std::sin(2.0 * M_PI * frequency * i / sample_rate)))[0];
+    if (i >= 19 * samples)
+    {
+      amplitude = std::max(amplitude,std::abs(output));
+    }
+  }
+  return amplitude;
+}
+
+} // namespace
+
+TEST(TestWrenchFilter, passSamplesWithoutParameters)
+{
+  ros::NodeHandle nh("~pass_through");
+  WrenchFilter filter;
+  ASSERT_TRUE(filter.init(nh));
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_TRUE(filter(uniform(i * 0.7)).isApprox(uniform(i * 0.7)));
+  }
+}
+
+TEST(TestWrenchFilter, rejectInvalidParameters)
+{
+  ros::NodeHandle even("~even_median");
+  even.setParam("median_window",4);
+  WrenchFilter filter;
+  EXPECT_FALSE(filter.init(even));
+
+  ros::NodeHandle nyquist("~beyond_nyquist");
+  nyquist.setParam("cutoff_frequency",600.0);
+  nyquist.setParam("sample_rate",1000.0);
+  EXPECT_FALSE(filter.init(nyquist));
+
+  ros::NodeHandle zero("~zero_denominator");
+  zero.setParam("b",std::vector<double>(2,0.5));
+  zero.setParam("a",std::vector<double>(2,0.0));
+  EXPECT_FALSE(filter.init(zero));
+}
+
+TEST(TestWrenchFilter, removeSpikesWithMedian)
+{
+  ros::NodeHandle nh("~median");
+  nh.setParam("median_window",5);
+  WrenchFilter filter;
+  ASSERT_TRUE(filter.init(nh));
+
+  // Up to two consecutive spikes vanish entirely
+  const double samples[] = {1.0, 1.0, 50.0, 1.0, 1.0, -50.0, 80.0, 1.0, 1.0, 1.0};
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(filter(uniform(samples[i]))[0], 1.0) << "Sample " << i;
+  }
+
+  // Steps pass after half the window
+  EXPECT_EQ(filter(uniform(2.0))[0], 1.0);
+  EXPECT_EQ(filter(uniform(2.0))[0], 1.0);
+  EXPECT_EQ(filter(uniform(2.0))[0], 2.0);
+}
+
+TEST(TestWrenchFilter, followDifferenceEquation)
+{
+  // The filter normalizes the coefficients with a[0]
+  const double b[] = {0.2, 0.4, 0.2};
+  const double a[] = {2.0, -1.2, 0.4};
+  ros::NodeHandle nh("~iir");
+  nh.setParam("b",std::vector<double>(b,b + 3));
+  nh.setParam("a",std::vector<double>(a,a + 3));
+  WrenchFilter filter;
+  ASSERT_TRUE(filter.init(nh));
+
+  // The first sample counts as constant since ever
+  const double first = 0.8;
+  const double steady = first * (b[0] + b[1] + b[2]) / (a[0] + a[1] + a[2]);
+  double x[] = {first, first, first};
+  double y[] = {steady, steady, steady};
+  for (int n = 0; n < 50; ++n)
+  {
+    x[2] = x[1];
+    x[1] = x[0];
+    x[0] = n == 0 ? first : std::cos(0.3 * n) + 0.1 * n;
+    y[2] = y[1];
+    y[1] = y[0];
+    y[0] = (b[0] * x[0] + b[1] * x[1] + b[2] * x[2] - a[1] * y[1] - a[2] * y[2]) / a[0];
+
+    const ctrl::Vector6D output = filter(uniform(x[0]));
+    for (int axis = 0; axis < 6; ++axis)
+    {
+      ASSERT_NEAR(output[axis], y[0], 1.0e-12) << "Sample " << n;
+    }
+  }
+
+  // A reset starts in steady state again
+  filter.reset();
+  EXPECT_NEAR(filter(uniform(first))[0], steady, 1.0e-12);
+}
+
+TEST(TestWrenchFilter, averageWithFirFilter)
+{
+  ros::NodeHandle nh("~fir");
+  nh.setParam("b",std::vector<double>(2,0.5));
+  WrenchFilter filter;
+  ASSERT_TRUE(filter.init(nh));
+
+  EXPECT_DOUBLE_EQ(filter(uniform(1.0))[0], 1.0);
+  EXPECT_DOUBLE_EQ(filter(uniform(3.0))[0], 2.0);
+  EXPECT_DOUBLE_EQ(filter(uniform(-1.0))[0], 1.0);
+}
+
+TEST(TestWrenchFilter, designButterworthLowPass)
+{
+  const double sample_rate = 1000.0;
+  ros::NodeHandle nh("~butterworth");
+  nh.setParam("cutoff_frequency",10.0);
+  nh.setParam("sample_rate",sample_rate);
+  WrenchFilter filter;
+  ASSERT_TRUE(filter.init(nh));
+
+  // Unity gain without start-up transients
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_NEAR(filter(uniform(5.0))[0], 5.0, 1.0e-9);
+  }
+
+  // -3 dB at the cutoff and -40 dB per decade above
+  filter.reset();
+  EXPECT_GT(amplitude(filter,1.0,sample_rate), 0.99);
+  filter.reset();
+  EXPECT_NEAR(amplitude(filter,10.0,sample_rate), std::sqrt(0.5), 0.01);
+  filter.reset();
+  EXPECT_LT(amplitude(filter,100.0,sample_rate), 0.011);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "test_wrench_filter");
+  return RUN_ALL_TESTS();
+}
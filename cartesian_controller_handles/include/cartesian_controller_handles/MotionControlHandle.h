@@ -48,9 +48,16 @@
 // ros_controls
 #include <controller_interface/controller.h>
 #include <hardware_interface/joint_state_interface.h>
+#include <realtime_tools/realtime_buffer.h>
+#include <realtime_tools/realtime_publisher.h>
+
+// Project
+#include <cartesian_controller_base/PoseMailbox.h>
 
 // Other
 #include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
 
 // KDL
 #include <kdl/chain.hpp>
@@ -70,6 +77,10 @@ namespace cartesian_controller_handles
  * controllers, such as the \ref CartesianMotionController or the \ref
  * CartesianComplianceController.
  *
+ * The interactive marker server runs in its own thread. The control loop only
+ * publishes when the marker has moved, and optionally repeats the latest pose
+ * at the rate given by the \a publish_rate parameter.
+ *
  * @tparam HardwareInterface Currently only JointStateInterface is supported
  */
 template <class HardwareInterface>
@@ -88,6 +99,8 @@ class MotionControlHandle : public controller_interface::Controller<HardwareInte
     /**
      * @brief Publish pose of the control handle as PoseStamped
      *
+     * Real-time safe. Publishes only if the marker has moved since the last
+     * call, or if the optional publish rate is due.
      */
     void update(const ros::Time& time, const ros::Duration& period);
 
@@ -95,7 +108,8 @@ class MotionControlHandle : public controller_interface::Controller<HardwareInte
     /**
      * @brief Move visual marker in RViz according to user interaction
      *
-     * This function also stores the marker pose internally.
+     * This function also hands the marker pose over to the control loop.
+     * It runs in the thread of the interactive marker server.
      *
      * @param feedback The message containing the current pose of the marker
      */
@@ -108,6 +122,16 @@ class MotionControlHandle : public controller_interface::Controller<HardwareInte
      */
     void updateMarkerMenuCallback(const visualization_msgs::InteractiveMarkerFeedbackConstPtr& feedback);
 
+    /**
+     * @brief Move the marker to where the control loop has reset it
+     *
+     * Runs outside the control loop, since updating the interactive marker
+     * server isn't real-time safe.
+     *
+     * @param event The timer event of this call
+     */
+    void resetMarker(const ros::TimerEvent& event);
+
     /**
      * @brief Add all relevant marker controls for interaction in RViz
      *
@@ -159,8 +183,33 @@ class MotionControlHandle : public controller_interface::Controller<HardwareInte
     boost::shared_ptr<
       KDL::ChainFkSolverPos_recursive>  m_fk_solver;
 
-    geometry_msgs::PoseStamped  m_current_pose;
-    ros::Publisher  m_pose_publisher;
+    geometry_msgs::PoseStamped  m_current_pose;   //!< In use by the control loop
+    cartesian_controller_base::PoseMailbox::Ptr m_pose_mailbox; //!< Direct channel to controllers in this process
+
+    // Publishing
+    typedef realtime_tools::RealtimePublisher<geometry_msgs::PoseStamped> PosePublisher;
+    boost::shared_ptr<PosePublisher>  m_pose_publisher;
+    double                            m_publish_rate;   //!< Of repeated poses. Zero for changes only.
+    ros::Time                         m_last_publish_time;
+    bool                              m_pose_changed;   //!< Not yet published
+
+    // Marker poses from the server's thread
+    struct MarkerPose
+    {
+      MarkerPose() : seq(0) {}
+
+      geometry_msgs::Pose pose;
+      unsigned long       seq;
+    };
+    realtime_tools::RealtimeBuffer<MarkerPose>  m_marker_input;
+    MarkerPose                                  m_marker_feedback;  //!< Latest feedback of the server's thread
+    unsigned long                               m_marker_seq;       //!< Last one taken over in the control loop
+
+    // Marker resets from the control loop
+    ros::Timer            m_reset_timer;
+    boost::mutex          m_reset_mutex;
+    geometry_msgs::Pose   m_reset_pose;
+    boost::atomic<bool>   m_reset_requested;
 
     // Interactive marker
     boost::shared_ptr<
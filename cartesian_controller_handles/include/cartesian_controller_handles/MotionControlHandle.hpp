@@ -39,13 +39,7 @@
 
 // Project
 #include <cartesian_controller_handles/MotionControlHandle.h>
-
-// KDL
-#include <kdl/tree.hpp>
-#include <kdl_parser/kdl_parser.hpp>
-
-// URDF
-#include <urdf/model.h>
+#include <cartesian_controller_base/RobotModelCache.h>
 
 
 namespace cartesian_controller_handles
@@ -54,6 +48,10 @@ namespace cartesian_controller_handles
 template <class HardwareInterface>
 MotionControlHandle<HardwareInterface>::
 MotionControlHandle()
+: m_publish_rate(0.0)
+, m_pose_changed(false)
+, m_marker_seq(0)
+, m_reset_requested(false)
 {
 }
 
@@ -61,6 +59,9 @@ template <class HardwareInterface>
 MotionControlHandle<HardwareInterface>::
 ~MotionControlHandle()
 {
+  // Stop the server's thread before its callbacks' members go away
+  m_reset_timer.stop();
+  m_server.reset();
 }
 
 template <class HardwareInterface>
@@ -68,8 +69,16 @@ void MotionControlHandle<HardwareInterface>::
 starting(const ros::Time& time)
 {
   m_current_pose = getEndEffectorPose();
-  m_server->setPose(m_marker.name,m_current_pose.pose);
-  m_server->applyChanges();
+  m_pose_changed = true;
+  m_last_publish_time = time;
+
+  // Ignore marker motion from before and let the marker follow
+  m_marker_seq = m_marker_input.readFromRT()->seq;
+  {
+    boost::mutex::scoped_lock lock(m_reset_mutex);
+    m_reset_pose = m_current_pose.pose;
+  }
+  m_reset_requested = true;
 }
 
 template <class HardwareInterface>
@@ -82,11 +91,49 @@ template <class HardwareInterface>
 void MotionControlHandle<HardwareInterface>::
 update(const ros::Time& time, const ros::Duration& period)
 {
-  // Publish marker pose
+  // Take over new marker poses
+  const MarkerPose& input = *m_marker_input.readFromRT();
+  if (input.seq != m_marker_seq)
+  {
+    m_marker_seq = input.seq;
+    m_current_pose.pose = input.pose;
+    m_pose_changed = true;
+  }
+
+  const bool repeat = m_publish_rate > 0.0 &&
+    m_last_publish_time + ros::Duration(1.0 / m_publish_rate) <= time;
+  if (!m_pose_changed && !repeat)
+  {
+    return;
+  }
+
+  // Hand over to Cartesian controllers in this process
+  const geometry_msgs::Pose& pose = m_current_pose.pose;
+  m_pose_mailbox->write(
+      KDL::Frame(
+        KDL::Rotation::Quaternion(
+          pose.orientation.x,
+          pose.orientation.y,
+          pose.orientation.z,
+          pose.orientation.w),
+        KDL::Vector(
+          pose.position.x,
+          pose.position.y,
+          pose.position.z)),
+      time);
+
+  // Publish marker pose.
+  // Retry in the next cycle if the publisher is still busy.
+  if (!m_pose_publisher->trylock())
+  {
+    return;
+  }
   m_current_pose.header.stamp = time;
   m_current_pose.header.frame_id = m_robot_base_link;
-  m_pose_publisher.publish(m_current_pose);
-  m_server->applyChanges();
+  m_pose_publisher->msg_ = m_current_pose;
+  m_pose_publisher->unlockAndPublish();
+  m_pose_changed = false;
+  m_last_publish_time = time;
 }
 
 
@@ -95,8 +142,7 @@ bool MotionControlHandle<HardwareInterface>::
 init(HardwareInterface* hw, ros::NodeHandle& nh)
 {
   std::string robot_description;
-  urdf::Model robot_model;
-  KDL::Tree   robot_tree;
+  cartesian_controller_base::RobotModelCache::ChainPtr robot_chain;
 
   // Get configuration from parameter server
   if (!nh.getParam("/robot_description",robot_description))
@@ -125,24 +171,31 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   }
 
   // Publishers
-  m_pose_publisher = nh.advertise<geometry_msgs::PoseStamped>(m_target_frame_topic,10);
-
-  // Build a kinematic chain of the robot
-  if (!robot_model.initString(robot_description))
+  nh.param("publish_rate",m_publish_rate,0.0);
+  m_pose_publisher.reset(new PosePublisher(nh,m_target_frame_topic,10));
+  m_pose_mailbox = cartesian_controller_base::PoseMailbox::get(
+      nh.resolveName(m_target_frame_topic),m_robot_base_link);
+
+  // Build a kinematic chain of the robot.
+  // Other controllers on the same robot share the parsed models.
+  if (!cartesian_controller_base::RobotModelCache::getUrdf(robot_description))
   {
     ROS_ERROR("Failed to parse urdf model from 'robot_description'");
     return false;
   }
-  if (!kdl_parser::treeFromUrdfModel(robot_model,robot_tree))
+  if (!cartesian_controller_base::RobotModelCache::getTree(robot_description))
   {
     ROS_ERROR("Failed to parse KDL tree from urdf model");
     return false;
   }
-  if (!robot_tree.getChain(m_robot_base_link,m_end_effector_link,m_robot_chain))
+  robot_chain = cartesian_controller_base::RobotModelCache::getChain(
+      robot_description,m_robot_base_link,m_end_effector_link);
+  if (!robot_chain)
   {
     ROS_ERROR_STREAM("Failed to parse robot chain from urdf model.");
     return false;
   }
+  m_robot_chain = *robot_chain;
 
   // Get names of controllable joints from the parameter server
   if (!nh.getParam("joints",m_joint_names))
@@ -161,9 +214,10 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   m_fk_solver.reset(new KDL::ChainFkSolverPos_recursive(m_robot_chain));
   m_current_pose = getEndEffectorPose();
 
-  // Configure the interactive marker for usage in RViz
+  // Configure the interactive marker for usage in RViz.
+  // The server handles feedback in its own thread.
   m_server.reset(new interactive_markers::InteractiveMarkerServer(
-    nh.getNamespace(), "", false));
+    nh.getNamespace(), "", true));
   m_marker.header.frame_id = m_robot_base_link;
   m_marker.header.stamp = ros::Time(0);   // makes frame_id const
   m_marker.scale = 0.1;
@@ -191,6 +245,13 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   // Activate configuration
   m_server->applyChanges();
 
+  // Start the control loop where the marker is
+  MarkerPose marker_pose;
+  marker_pose.pose = m_marker.pose;
+  m_marker_input.writeFromNonRT(marker_pose);
+  m_reset_timer = nh.createTimer(
+      ros::Duration(0.1),&MotionControlHandle<HardwareInterface>::resetMarker,this);
+
   return true;
 }
 
@@ -203,10 +264,28 @@ updateMotionControlCallback(
   m_server->setPose(feedback->marker_name,feedback->pose);
   m_server->applyChanges();
 
-  // Store for later broadcasting
-  m_current_pose.pose = feedback->pose;
-  m_current_pose.header.stamp = ros::Time::now();
+  // Hand over for broadcasting in the control loop
+  m_marker_feedback.pose = feedback->pose;
+  m_marker_feedback.seq++;
+  m_marker_input.writeFromNonRT(m_marker_feedback);
+}
 
+template <class HardwareInterface>
+void MotionControlHandle<HardwareInterface>::
+resetMarker(const ros::TimerEvent& event)
+{
+  if (!m_reset_requested.exchange(false))
+  {
+    return;
+  }
+
+  geometry_msgs::Pose pose;
+  {
+    boost::mutex::scoped_lock lock(m_reset_mutex);
+    pose = m_reset_pose;
+  }
+  m_server->setPose(m_marker.name,pose);
+  m_server->applyChanges();
 }
 
 
@@ -42,9 +42,25 @@
 
 // Project
 #include <cartesian_controller_base/cartesian_controller_base.h>
+#include <cartesian_controller_base/WrenchFilter.h>
+#include <cartesian_controller_base/BiasEstimator.h>
+#include <cartesian_controller_base/ToolIdentification.h>
+#include <cartesian_controller_base/CompactStream.h>
+#include <cartesian_controller_base/CompactWrench.h>
+#include <cartesian_controller_base/CompactWrenchBatch.h>
 
 // ROS
 #include <std_srvs/Trigger.h>
+#include <std_srvs/SetBool.h>
+
+// ros_control
+#include <hardware_interface/force_torque_sensor_interface.h>
+#include <hardware_interface/robot_hw.h>
+#include <realtime_tools/realtime_buffer.h>
+
+// Other
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
 
 namespace cartesian_force_controller
 {
@@ -58,6 +74,17 @@ namespace cartesian_force_controller
  * controller additionally listens to the specified force-torque sensor signals
  * and computes the superposition with the target wrench.
  *
+ * Sensor samples come either from a geometry_msgs::WrenchStamped topic or
+ * directly from a hardware_interface::ForceTorqueSensorInterface handle,
+ * which is read in each update().  The control loop filters all samples and
+ * removes the sensor's bias, which is estimated when the \a signal_taring
+ * service is called and, optionally, follows slow drift between tarings.
+ *
+ * The tool's weight is compensated either in each solver iteration with the
+ * simulated robot's sensor orientation, or once per control cycle with the
+ * real robot's sensor orientation.  The \a identify_tool service estimates
+ * the tool's mass and center of mass online from the filtered sensor samples.
+ *
  * The underlying solver maps this remaining wrench to joint motion.
  * Users can steer their robot with this control in free space. The speed of
  * the end effector motion is set with PD gains on each Cartesian axes.
@@ -70,7 +97,8 @@ namespace cartesian_force_controller
  * real hardware, such that some experiments might be required for each use
  * case.
  *
- * @tparam HardwareInterface The interface to support. Either PositionJointInterface or VelocityJointInterface
+ * @tparam HardwareInterface The interface to support. One of those of
+ * cartesian_controller_base::CartesianControllerBase
  */
 template <class HardwareInterface>
 class CartesianForceController : public virtual cartesian_controller_base::CartesianControllerBase<HardwareInterface>
@@ -89,6 +117,17 @@ class CartesianForceController : public virtual cartesian_controller_base::Carte
     typedef cartesian_controller_base::CartesianControllerBase<HardwareInterface> Base;
 
   protected:
+    /**
+     * @brief Get the force-torque sensor interface before init()
+     *
+     * Sensor handles are no resources of the joint hardware interface, so
+     * they are taken directly from the robot hardware.
+     */
+    bool initRequest(hardware_interface::RobotHW* robot_hw,
+                     ros::NodeHandle&             root_nh,
+                     ros::NodeHandle&             controller_nh,
+                     controller_interface::ControllerBase::ClaimedResources& claimed_resources);
+
     /**
      * @brief Compute the net force out of target wrench and measured sensor wrench
      *
@@ -96,24 +135,92 @@ class CartesianForceController : public virtual cartesian_controller_base::Carte
      */
     ctrl::Vector6D        computeForceError();
     std::string           m_new_ft_sensor_ref;
+    int                   m_new_ft_sensor_ref_index;
     void setFtSensorReferenceFrame(const std::string& new_ref);
 
+    /**
+     * @brief Take the latest target wrench and process new sensor samples
+     *
+     * Call this once at the beginning of each control cycle. All solver
+     * iterations of that cycle then work on the same consistent wrenches.
+     *
+     * @param period The time since the last control cycle
+     */
+    void updateWrenches(const ros::Duration& period);
+
   private:
     ctrl::Vector6D        compensateGravity();
 
+    //! The tool's weight in the robot base frame, acting on the sensor
+    ctrl::Vector6D        weightInBaseLink(const KDL::Rotation& sensor_orientation) const;
+
+    //! Filter a new sensor sample and use it for taring
+    void processFtSensorSample(const KDL::Wrench& sample);
+
+    //! Remember the gravity effects at the moment of taring
+    void tareGravity();
+
+    //! Apply the identified tool parameters if they are reliable
+    void finishToolIdentification();
+
     void targetWrenchCallback(const geometry_msgs::WrenchStamped& wrench);
+    void compactTargetWrenchCallback(const cartesian_controller_base::CompactWrench& wrench);
+    void compactTargetWrenchBatchCallback(const cartesian_controller_base::CompactWrenchBatch& batch);
     void ftSensorWrenchCallback(const geometry_msgs::WrenchStamped& wrench);
     bool signalTaringCallback(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res);
+    bool identifyToolCallback(std_srvs::SetBool::Request& req, std_srvs::SetBool::Response& res);
 
     ros::ServiceServer    m_signal_taring_server;
+    ros::ServiceServer    m_identify_tool_server;
     ros::Subscriber       m_target_wrench_subscriber;
     ros::Subscriber       m_ft_sensor_wrench_subscriber;
     ctrl::Vector6D        m_target_wrench;
     ctrl::Vector6D        m_ft_sensor_wrench;
-    ctrl::Vector6D        m_weight_force;
+    realtime_tools::RealtimeBuffer<KDL::Wrench> m_target_wrench_input;
+
+    // Compact target wrenches in the end effector link
+    ros::Subscriber       m_compact_target_wrench_subscriber;
+    ros::Subscriber       m_compact_target_wrench_batch_subscriber;
+    cartesian_controller_base::CompactStream m_compact_target_wrench_stream;
+    cartesian_controller_base::CompactStream m_compact_target_wrench_batch_stream;
+
+    // Sensor input
+    hardware_interface::ForceTorqueSensorInterface* m_ft_sensor_interface;
+    hardware_interface::ForceTorqueSensorHandle     m_ft_sensor_handle;
+    bool                  m_ft_sensor_from_hardware;
+    boost::lockfree::spsc_queue<KDL::Wrench, boost::lockfree::capacity<64> > m_ft_sensor_samples;
+
+    // Sensor processing
+    cartesian_controller_base::WrenchFilter   m_ft_sensor_filter;
+    cartesian_controller_base::BiasEstimator  m_ft_sensor_bias;
+    ctrl::Vector6D        m_ft_sensor_filtered;
+    boost::atomic<bool>   m_taring_requested;
+    // Gravity compensation
+    ctrl::Vector3D        m_gravity;              ///< In base frame
+    ctrl::Vector3D        m_weight_force;         ///< In base frame
     ctrl::Vector6D        m_grav_comp_during_taring;
-    ctrl::Vector3D        m_center_of_mass;
+    ctrl::Vector3D        m_center_of_mass;       ///< In sensor frame
+    bool                  m_gravity_per_cycle;
+    KDL::Rotation         m_ft_sensor_orientation;  ///< For this control cycle
+    ctrl::Vector6D        m_gravity_compensation;   ///< For this control cycle
+
+    // Tool identification
+    enum IdentificationRequest {IDENTIFICATION_NONE, IDENTIFICATION_START, IDENTIFICATION_STOP};
+    struct ToolEstimate
+    {
+      double          mass;
+      ctrl::Vector3D  center_of_mass;
+      unsigned long   samples;
+      bool            converged;
+      bool            running;
+    };
+    cartesian_controller_base::ToolIdentification m_tool_identification;
+    bool                  m_identifying;
+    boost::atomic<int>    m_identification_request;
+    boost::atomic<bool>   m_identification_done;
+    ToolEstimate          m_tool_estimate;  ///< Written by the control loop before m_identification_done
     std::string           m_ft_sensor_ref_link;
+    int                   m_ft_sensor_ref_link_index;
     KDL::Frame            m_ft_sensor_transform;
 };
 
@@ -45,6 +45,7 @@
 
 // Other
 #include <boost/algorithm/clamp.hpp>
+#include <sstream>
 
 namespace cartesian_force_controller
 {
@@ -52,10 +53,30 @@ namespace cartesian_force_controller
 template <class HardwareInterface>
 CartesianForceController<HardwareInterface>::
 CartesianForceController()
-: Base::CartesianControllerBase()
+: Base::CartesianControllerBase(),
+  m_ft_sensor_interface(NULL),
+  m_ft_sensor_from_hardware(false),
+  m_taring_requested(false),
+  m_gravity_per_cycle(false),
+  m_identifying(false),
+  m_identification_request(IDENTIFICATION_NONE),
+  m_identification_done(false)
 {
 }
 
+template <class HardwareInterface>
+bool CartesianForceController<HardwareInterface>::
+initRequest(hardware_interface::RobotHW* robot_hw,
+            ros::NodeHandle&             root_nh,
+            ros::NodeHandle&             controller_nh,
+            controller_interface::ControllerBase::ClaimedResources& claimed_resources)
+{
+  // May be NULL if the robot has no such sensors
+  m_ft_sensor_interface = robot_hw->get<hardware_interface::ForceTorqueSensorInterface>();
+
+  return Base::initRequest(robot_hw,root_nh,controller_nh,claimed_resources);
+}
+
 template <class HardwareInterface>
 bool CartesianForceController<HardwareInterface>::
 init(HardwareInterface* hw, ros::NodeHandle& nh)
@@ -67,13 +88,78 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
     ROS_ERROR_STREAM("Failed to load " << nh.getNamespace() + "/ft_sensor_ref_link" << " from parameter server");
     return false;
   }
+  m_ft_sensor_ref_link_index = Base::getLinkIndex(m_ft_sensor_ref_link);
 
   // Make sure sensor wrenches are interpreted correctly
   setFtSensorReferenceFrame(Base::m_end_effector_link);
 
   m_signal_taring_server = nh.advertiseService("signal_taring",&CartesianForceController<HardwareInterface>::signalTaringCallback,this);
+  m_identify_tool_server = nh.advertiseService("identify_tool",&CartesianForceController<HardwareInterface>::identifyToolCallback,this);
   m_target_wrench_subscriber = nh.subscribe("target_wrench",2,&CartesianForceController<HardwareInterface>::targetWrenchCallback,this);
-  m_ft_sensor_wrench_subscriber = nh.subscribe("/rokubimini/ft_sensor0/ft_sensor_readings/wrench",2,&CartesianForceController<HardwareInterface>::ftSensorWrenchCallback,this);
+
+  // Compact variants for constrained links
+  if (!m_compact_target_wrench_stream.init(nh,"compact/target_wrench",Base::m_end_effector_link) ||
+      !m_compact_target_wrench_batch_stream.init(nh,"compact/target_wrench_batch",Base::m_end_effector_link))
+  {
+    return false;
+  }
+  m_compact_target_wrench_subscriber = nh.subscribe("compact/target_wrench",2,&CartesianForceController<HardwareInterface>::compactTargetWrenchCallback,this);
+  m_compact_target_wrench_batch_subscriber = nh.subscribe("compact/target_wrench_batch",2,&CartesianForceController<HardwareInterface>::compactTargetWrenchBatchCallback,this);
+
+  // Sensor input, either from the hardware or from a topic
+  std::string ft_sensor_source;
+  nh.param<std::string>("ft_sensor/source",ft_sensor_source,"topic");
+  if (ft_sensor_source == "hardware")
+  {
+    std::string ft_sensor_name;
+    if (!nh.getParam("ft_sensor/name",ft_sensor_name))
+    {
+      ROS_ERROR_STREAM("Failed to load " << nh.getNamespace() + "/ft_sensor/name" << " from parameter server");
+      return false;
+    }
+    if (!m_ft_sensor_interface)
+    {
+      ROS_ERROR_STREAM(nh.getNamespace() << ": The robot hardware has no force-torque sensor interface."
+          << " Note that this needs the controller to be loaded by a controller manager.");
+      return false;
+    }
+    try
+    {
+      m_ft_sensor_handle = m_ft_sensor_interface->getHandle(ft_sensor_name);
+    }
+    catch (const hardware_interface::HardwareInterfaceException& ex)
+    {
+      ROS_ERROR_STREAM(nh.getNamespace() << ": " << ex.what());
+      return false;
+    }
+    if (!m_ft_sensor_handle.getFrameId().empty() && m_ft_sensor_handle.getFrameId() != m_ft_sensor_ref_link)
+    {
+      ROS_WARN_STREAM(nh.getNamespace() << ": Sensor " << ft_sensor_name << " measures in "
+          << m_ft_sensor_handle.getFrameId() << ", but ft_sensor_ref_link is " << m_ft_sensor_ref_link);
+    }
+    m_ft_sensor_from_hardware = true;
+  }
+  else if (ft_sensor_source == "topic")
+  {
+    std::string ft_sensor_topic;
+    nh.param<std::string>("ft_sensor/topic",ft_sensor_topic,"/rokubimini/ft_sensor0/ft_sensor_readings/wrench");
+    m_ft_sensor_wrench_subscriber = nh.subscribe(
+        ft_sensor_topic,10,&CartesianForceController<HardwareInterface>::ftSensorWrenchCallback,this,
+        ros::TransportHints().tcpNoDelay());
+    m_ft_sensor_from_hardware = false;
+  }
+  else
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << "/ft_sensor/source must be either topic or hardware. Got " << ft_sensor_source);
+    return false;
+  }
+
+  ros::NodeHandle filter_nh(nh.getNamespace() + "/ft_sensor/filter");
+  ros::NodeHandle bias_nh(nh.getNamespace() + "/ft_sensor/bias");
+  if (!m_ft_sensor_filter.init(filter_nh) || !m_ft_sensor_bias.init(bias_nh))
+  {
+    return false;
+  }
 
   // Initialize tool and gravity compensation
   std::map<std::string, double> gravity;
@@ -96,12 +182,35 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
   m_center_of_mass = ctrl::Vector3D(tool["com_x"],tool["com_y"],tool["com_z"]);
 
   // In base frame
-  m_weight_force.head<3>() = tool["mass"] * ctrl::Vector3D(gravity["x"],gravity["y"],gravity["z"]);
-  m_weight_force.tail<3>() = ctrl::Vector3D::Zero();  // Update in control cycle
-  m_grav_comp_during_taring = -m_weight_force;
+  m_gravity = ctrl::Vector3D(gravity["x"],gravity["y"],gravity["z"]);
+  m_weight_force = tool["mass"] * m_gravity;
+  m_grav_comp_during_taring.head<3>() = -m_weight_force;
+  m_grav_comp_during_taring.tail<3>() = ctrl::Vector3D::Zero();
+
+  std::string gravity_compensation;
+  nh.param<std::string>("gravity_compensation",gravity_compensation,"per_iteration");
+  if (gravity_compensation != "per_iteration" && gravity_compensation != "per_cycle")
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << "/gravity_compensation must be either per_iteration or per_cycle. Got " << gravity_compensation);
+    return false;
+  }
+  m_gravity_per_cycle = gravity_compensation == "per_cycle";
+  m_ft_sensor_orientation = Base::getLinkFrame(m_ft_sensor_ref_link_index).M;
+  m_gravity_compensation = -weightInBaseLink(m_ft_sensor_orientation) - m_grav_comp_during_taring;
+
+  double forgetting_factor;
+  nh.param("tool_identification/forgetting_factor",forgetting_factor,1.0);
+  if (forgetting_factor <= 0.0 || forgetting_factor > 1.0)
+  {
+    ROS_ERROR_STREAM(nh.getNamespace() << "/tool_identification/forgetting_factor must be in (0, 1]");
+    return false;
+  }
+  m_tool_identification = cartesian_controller_base::ToolIdentification(forgetting_factor);
 
   m_target_wrench.setZero();
   m_ft_sensor_wrench.setZero();
+  m_ft_sensor_filtered.setZero();
+  m_target_wrench_input.writeFromNonRT(KDL::Wrench::Zero());
 
   return true;
 }
@@ -111,6 +220,14 @@ void CartesianForceController<HardwareInterface>::
 starting(const ros::Time& time)
 {
   Base::starting(time);
+
+  // Start filtering with the first sample of update(). Samples that
+  // arrived before the controller stopped are outdated.
+  m_ft_sensor_filter.reset();
+  KDL::Wrench outdated;
+  while (m_ft_sensor_samples.pop(outdated))
+  {
+  }
 }
 
 template <class HardwareInterface>
@@ -125,36 +242,77 @@ update(const ros::Time& time, const ros::Duration& period)
 {
   // Control the robot motion in such a way that the resulting net force
   // vanishes. This internal control needs some simulation time steps.
-  for (int i = 0; i < Base::m_iterations; ++i)
+  updateWrenches(period);
+  Base::startIterations(period);
+  for (int i = 0; i < Base::m_settings.iterations; ++i)
   {
     // The internal 'simulation time' is deliberately independent of the outer
     // control cycle.
-    ros::Duration internal_period(0.02);
+    ros::Duration internal_period = Base::m_settings.internal_period;
 
     // Compute the net force
     ctrl::Vector6D error = computeForceError();
 
+    // Stop early in adaptive mode
+    if (!Base::continueIterations(error))
+    {
+      break;
+    }
+
     // Turn Cartesian error into joint motion
     Base::computeJointControlCmds(error,internal_period);
   }
+  Base::finishIterations();
 
   // Write final commands to the hardware interface
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
 }
 
 template <>
 void CartesianForceController<hardware_interface::VelocityJointInterface>::
 update(const ros::Time& time, const ros::Duration& period)
 {
+  updateWrenches(period);
+
+  Base::startIterations(period);
+
   // Simulate only one step forward.
   // The constant simulation time adds to solver stability.
-  ros::Duration internal_period(0.02);
-
+  ros::Duration internal_period = Base::m_settings.internal_period;
   ctrl::Vector6D error = computeForceError();
 
   Base::computeJointControlCmds(error,internal_period);
+  Base::finishIterations();
+
+  Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+}
+
+template <>
+void CartesianForceController<hardware_interface::EffortJointInterface>::
+update(const ros::Time& time, const ros::Duration& period)
+{
+  // Start with the robot state of this cycle
+  Base::startIterations(period);
+
+  updateWrenches(period);
+
+  // One step on the real robot state without simulation.
+  // The PD controller's output is the end effector wrench.
+  ctrl::Vector6D error = computeForceError();
+
+  Base::computeJointControlCmds(error,period);
+  Base::finishIterations();
 
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
 }
 
 template <class HardwareInterface>
@@ -162,11 +320,126 @@ ctrl::Vector6D CartesianForceController<HardwareInterface>::
 computeForceError()
 {
   // Superimpose target wrench and sensor wrench in base frame
-  return Base::displayInBaseLink(m_ft_sensor_wrench,m_new_ft_sensor_ref)
-    + Base::displayInBaseLink(m_target_wrench,Base::m_end_effector_link)
+  return Base::displayInBaseLink(m_ft_sensor_wrench,m_new_ft_sensor_ref_index)
+    + Base::displayInBaseLink(m_target_wrench,Base::m_end_effector_link_index)
     + compensateGravity();
 }
 
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+updateWrenches(const ros::Duration& period)
+{
+  const KDL::Wrench& target_wrench = *m_target_wrench_input.readFromRT();
+  for (int i = 0; i < 6; ++i)
+  {
+    m_target_wrench[i] = target_wrench(i);
+  }
+
+  if (m_taring_requested.exchange(false))
+  {
+    m_ft_sensor_bias.startTaring();
+  }
+  switch (m_identification_request.exchange(IDENTIFICATION_NONE))
+  {
+    case IDENTIFICATION_START:
+      m_tool_identification.reset();
+      m_identifying = true;
+      break;
+    case IDENTIFICATION_STOP:
+      finishToolIdentification();
+      break;
+    default:
+      break;
+  }
+
+  // The sensor's orientation for this cycle
+  m_ft_sensor_orientation = m_gravity_per_cycle || m_identifying
+    ? Base::getMeasuredLinkOrientation(m_ft_sensor_ref_link_index)
+    : Base::getLinkFrame(m_ft_sensor_ref_link_index).M;
+
+  // Process all sensor samples since the last cycle
+  if (m_ft_sensor_from_hardware)
+  {
+    const double* force = m_ft_sensor_handle.getForce();
+    const double* torque = m_ft_sensor_handle.getTorque();
+    KDL::Wrench sample;
+    if (force)
+    {
+      sample.force = KDL::Vector(force[0],force[1],force[2]);
+    }
+    if (torque)
+    {
+      sample.torque = KDL::Vector(torque[0],torque[1],torque[2]);
+    }
+    processFtSensorSample(sample);
+  }
+  else
+  {
+    KDL::Wrench sample;
+    while (m_ft_sensor_samples.pop(sample))
+    {
+      processFtSensorSample(sample);
+    }
+  }
+  m_ft_sensor_wrench = m_ft_sensor_filtered - m_ft_sensor_bias.bias();
+  Base::recordWrench(m_ft_sensor_wrench);
+
+  // Identify with the sensor's wrench in its own frame
+  if (m_identifying)
+  {
+    KDL::Wrench filtered;
+    for (int i = 0; i < 6; ++i)
+    {
+      filtered(i) = m_ft_sensor_filtered[i];
+    }
+    const KDL::Wrench sample = m_ft_sensor_transform.Inverse() * filtered;
+    const KDL::Vector gravity = m_ft_sensor_orientation.Inverse(
+        KDL::Vector(m_gravity[0],m_gravity[1],m_gravity[2]));
+
+    ctrl::Vector6D wrench;
+    for (int i = 0; i < 6; ++i)
+    {
+      wrench[i] = sample(i);
+    }
+    m_tool_identification.update(ctrl::Vector3D(gravity.x(),gravity.y(),gravity.z()),wrench);
+  }
+
+  // Compensate once for all iterations of this cycle
+  if (m_gravity_per_cycle)
+  {
+    m_gravity_compensation = -weightInBaseLink(m_ft_sensor_orientation) - m_grav_comp_during_taring;
+  }
+
+  // Follow sensor drift with what remains after gravity compensation
+  if (m_ft_sensor_bias.tracking() && !m_ft_sensor_bias.taring())
+  {
+    ctrl::Vector6D residual = Base::displayInTipLink(
+        Base::displayInBaseLink(m_ft_sensor_wrench,m_new_ft_sensor_ref_index) + compensateGravity(),
+        m_new_ft_sensor_ref_index);
+    m_ft_sensor_bias.track(residual,period);
+  }
+}
+
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+processFtSensorSample(const KDL::Wrench& sample)
+{
+  // Compute how the measured wrench appears in the frame of interest.
+  const KDL::Wrench tmp = m_ft_sensor_transform * sample;
+
+  ctrl::Vector6D wrench;
+  for (int i = 0; i < 6; ++i)
+  {
+    wrench[i] = tmp(i);
+  }
+  m_ft_sensor_filtered = m_ft_sensor_filter(wrench);
+
+  if (m_ft_sensor_bias.addSample(m_ft_sensor_filtered))
+  {
+    tareGravity();
+  }
+}
+
 template <class HardwareInterface>
 void CartesianForceController<HardwareInterface>::
 setFtSensorReferenceFrame(const std::string& new_ref)
@@ -174,22 +447,12 @@ setFtSensorReferenceFrame(const std::string& new_ref)
   // Compute static transform from the force torque sensor to the new reference
   // frame of interest.
   m_new_ft_sensor_ref = new_ref;
+  m_new_ft_sensor_ref_index = Base::getLinkIndex(m_new_ft_sensor_ref);
 
   // Joint positions should cancel out, i.e. it doesn't matter as long as they
   // are the same for both transformations.
-  KDL::JntArray jnts(Base::m_forward_dynamics_solver.getPositions());
-
-  KDL::Frame sensor_ref;
-  Base::m_forward_kinematics_solver->JntToCart(
-      jnts,
-      sensor_ref,
-      m_ft_sensor_ref_link);
-
-  KDL::Frame new_sensor_ref;
-  Base::m_forward_kinematics_solver->JntToCart(
-      jnts,
-      new_sensor_ref,
-      m_new_ft_sensor_ref);
+  const KDL::Frame& sensor_ref = Base::getLinkFrame(m_ft_sensor_ref_link_index);
+  const KDL::Frame& new_sensor_ref = Base::getLinkFrame(m_new_ft_sensor_ref_index);
 
   m_ft_sensor_transform = new_sensor_ref.Inverse() * sensor_ref;
 }
@@ -198,34 +461,77 @@ template <class HardwareInterface>
 ctrl::Vector6D CartesianForceController<HardwareInterface>::
 compensateGravity()
 {
-  ctrl::Vector6D compensating_force = ctrl::Vector6D::Zero();
+  if (m_gravity_per_cycle)
+  {
+    return m_gravity_compensation;
+  }
 
-  // Compute actual gravity effects in sensor frame
-  ctrl::Vector6D tmp = Base::displayInTipLink(m_weight_force,m_ft_sensor_ref_link);
-  tmp.tail<3>() = m_center_of_mass.cross(tmp.head<3>()); // M = r x F
+  // Add actual gravity compensation for the simulated robot and
+  // remove deprecated terms from moment of taring
+  return -weightInBaseLink(Base::getLinkFrame(m_ft_sensor_ref_link_index).M)
+    - m_grav_comp_during_taring;
+}
 
-  // Display in base link
-  m_weight_force = Base::displayInBaseLink(tmp,m_ft_sensor_ref_link);
+template <class HardwareInterface>
+ctrl::Vector6D CartesianForceController<HardwareInterface>::
+weightInBaseLink(const KDL::Rotation& sensor_orientation) const
+{
+  // M = r x F with the center of mass rotated into the base frame
+  const KDL::Vector com = sensor_orientation * KDL::Vector(
+      m_center_of_mass[0],m_center_of_mass[1],m_center_of_mass[2]);
+
+  ctrl::Vector6D weight;
+  weight.head<3>() = m_weight_force;
+  weight.tail<3>() = ctrl::Vector3D(com.x(),com.y(),com.z()).cross(m_weight_force);
+  return weight;
+}
 
-  // Add actual gravity compensation
-  compensating_force -= m_weight_force;
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+targetWrenchCallback(const geometry_msgs::WrenchStamped& wrench)
+{
+  KDL::Wrench tmp;
+  tmp[0] = wrench.wrench.force.x;
+  tmp[1] = wrench.wrench.force.y;
+  tmp[2] = wrench.wrench.force.z;
+  tmp[3] = wrench.wrench.torque.x;
+  tmp[4] = wrench.wrench.torque.y;
+  tmp[5] = wrench.wrench.torque.z;
 
-  // Remove deprecated terms from moment of taring
-  compensating_force -= m_grav_comp_during_taring;
+  m_target_wrench_input.writeFromNonRT(tmp);
+}
 
-  return compensating_force;
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+compactTargetWrenchCallback(const cartesian_controller_base::CompactWrench& wrench)
+{
+  if (!m_compact_target_wrench_stream.accept(wrench.frame,wrench.seq))
+  {
+    return;
+  }
+  m_target_wrench_input.writeFromNonRT(
+      cartesian_controller_base::CompactStream::toWrench(wrench.wrench.data()));
 }
 
 template <class HardwareInterface>
 void CartesianForceController<HardwareInterface>::
-targetWrenchCallback(const geometry_msgs::WrenchStamped& wrench)
+compactTargetWrenchBatchCallback(const cartesian_controller_base::CompactWrenchBatch& batch)
 {
-  m_target_wrench[0] = wrench.wrench.force.x;
-  m_target_wrench[1] = wrench.wrench.force.y;
-  m_target_wrench[2] = wrench.wrench.force.z;
-  m_target_wrench[3] = wrench.wrench.torque.x;
-  m_target_wrench[4] = wrench.wrench.torque.y;
-  m_target_wrench[5] = wrench.wrench.torque.z;
+  if (!m_compact_target_wrench_batch_stream.accept(batch.frame,batch.seq))
+  {
+    return;
+  }
+  if (batch.stamps.empty() || batch.wrenches.size() != 6 * batch.stamps.size())
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got compact target wrenches with "
+        << batch.wrenches.size() << " values for " << batch.stamps.size()
+        << " stamps. Expected six values per stamp.");
+    return;
+  }
+
+  // Only the latest sample matters
+  m_target_wrench_input.writeFromNonRT(
+      cartesian_controller_base::CompactStream::toWrench(&batch.wrenches[batch.wrenches.size() - 6]));
 }
 
 template <class HardwareInterface>
@@ -240,33 +546,104 @@ ftSensorWrenchCallback(const geometry_msgs::WrenchStamped& wrench)
   tmp[4] = wrench.wrench.torque.y;
   tmp[5] = wrench.wrench.torque.z;
 
-  // Compute how the measured wrench appears in the frame of interest.
-  tmp = m_ft_sensor_transform * tmp;
-
-  m_ft_sensor_wrench[0] = tmp[0];
-  m_ft_sensor_wrench[1] = tmp[1];
-  m_ft_sensor_wrench[2] = tmp[2];
-  m_ft_sensor_wrench[3] = tmp[3];
-  m_ft_sensor_wrench[4] = tmp[4];
-  m_ft_sensor_wrench[5] = tmp[5];
+  // Nobody consumes samples while the control loop doesn't run. Stop
+  // pushing, so that the queue doesn't hold old samples on activation.
+  if (!this->isRunning())
+  {
+    return;
+  }
+
+  // Samples are dropped if the control loop falls behind
+  m_ft_sensor_samples.push(tmp);
 }
 
 template <class HardwareInterface>
 bool CartesianForceController<HardwareInterface>::
 signalTaringCallback(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res)
 {
-  // Compute current gravity effects in sensor frame
-  ctrl::Vector6D tmp = Base::displayInTipLink(m_weight_force,m_ft_sensor_ref_link);
-  tmp.tail<3>() = m_center_of_mass.cross(tmp.head<3>()); // M = r x F
+  // The control loop averages the next samples into a new bias
+  m_taring_requested = true;
+
+  res.message = "Taring with the next sensor samples.";
+  res.success = true;
+  return true;
+}
 
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+tareGravity()
+{
   // Taring the sensor is like adding a virtual force that exactly compensates
   // the weight force.
-  tmp = -tmp;
+  m_grav_comp_during_taring = -weightInBaseLink(m_ft_sensor_orientation);
+}
 
-  // Display in base link
-  m_grav_comp_during_taring = Base::displayInBaseLink(tmp,m_ft_sensor_ref_link);
+template <class HardwareInterface>
+void CartesianForceController<HardwareInterface>::
+finishToolIdentification()
+{
+  m_tool_estimate.mass = m_tool_identification.mass();
+  m_tool_estimate.center_of_mass = m_tool_identification.centerOfMass();
+  m_tool_estimate.samples = m_tool_identification.samples();
+  m_tool_estimate.converged = m_tool_identification.converged();
+  m_tool_estimate.running = m_identifying;
 
-  res.message = "Got it.";
+  if (m_identifying && m_tool_estimate.converged)
+  {
+    m_weight_force = m_tool_estimate.mass * m_gravity;
+    m_center_of_mass = m_tool_estimate.center_of_mass;
+
+    // The old taring assumed the old tool
+    m_ft_sensor_bias.startTaring();
+  }
+  m_identifying = false;
+  m_identification_done = true;
+}
+
+template <class HardwareInterface>
+bool CartesianForceController<HardwareInterface>::
+identifyToolCallback(std_srvs::SetBool::Request& req, std_srvs::SetBool::Response& res)
+{
+  if (req.data)
+  {
+    m_identification_request = IDENTIFICATION_START;
+    res.message = "Identifying. Move the tool through different orientations without contact.";
+    res.success = true;
+    return true;
+  }
+
+  // Let the control loop finish and wait for its result
+  m_identification_done = false;
+  m_identification_request = IDENTIFICATION_STOP;
+  for (int i = 0; i < 100 && !m_identification_done; ++i)
+  {
+    ros::Duration(0.01).sleep();
+  }
+  if (!m_identification_done)
+  {
+    res.message = "No response from the control loop. Is the controller running?";
+    res.success = false;
+    return true;
+  }
+  if (!m_tool_estimate.running)
+  {
+    res.message = "No identification running.";
+    res.success = false;
+    return true;
+  }
+
+  std::stringstream estimate;
+  estimate << "mass " << m_tool_estimate.mass << ", center of mass ["
+    << m_tool_estimate.center_of_mass.transpose() << "] in " << m_ft_sensor_ref_link
+    << " from " << m_tool_estimate.samples << " samples";
+  if (!m_tool_estimate.converged)
+  {
+    res.message = "Not enough different tool orientations. Keeping the previous tool with the estimate "
+      + estimate.str();
+    res.success = false;
+    return true;
+  }
+  res.message = "Using " + estimate.str() + ". Taring with the next sensor samples.";
   res.success = true;
   return true;
 }
@@ -61,5 +61,35 @@ namespace velocity_controllers
     hardware_interface::VelocityJointInterface> CartesianForceController;
 }
 
+namespace pos_vel_controllers
+{
+  /**
+   * @brief Cartesian force controller that turns end-effector target wrenches and sensor measurements into commands for a chain of position and velocity interfaces.
+   */
+  typedef cartesian_force_controller::CartesianForceController<
+    hardware_interface::PosVelJointInterface> CartesianForceController;
+}
+
+namespace pos_vel_acc_controllers
+{
+  /**
+   * @brief Cartesian force controller that turns end-effector target wrenches and sensor measurements into commands for a chain of position, velocity and acceleration interfaces.
+   */
+  typedef cartesian_force_controller::CartesianForceController<
+    hardware_interface::PosVelAccJointInterface> CartesianForceController;
+}
+
+namespace effort_controllers
+{
+  /**
+   * @brief Cartesian force controller that turns end-effector target wrenches and sensor measurements into commands for a chain of effort interfaces.
+   */
+  typedef cartesian_force_controller::CartesianForceController<
+    hardware_interface::EffortJointInterface> CartesianForceController;
+}
+
 PLUGINLIB_EXPORT_CLASS(position_controllers::CartesianForceController, controller_interface::ControllerBase)
 PLUGINLIB_EXPORT_CLASS(velocity_controllers::CartesianForceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_controllers::CartesianForceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_acc_controllers::CartesianForceController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(effort_controllers::CartesianForceController, controller_interface::ControllerBase)
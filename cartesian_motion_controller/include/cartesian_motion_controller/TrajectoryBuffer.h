@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    TrajectoryBuffer.h
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+#ifndef TRAJECTORY_BUFFER_H_INCLUDED
+#define TRAJECTORY_BUFFER_H_INCLUDED
+
+// ROS
+#include <ros/time.h>
+
+// KDL
+#include <kdl/frames.hpp>
+
+// Other
+#include <vector>
+#include <cstddef>
+
+namespace cartesian_motion_controller
+{
+
+/**
+ * @brief A ring buffer of timestamped Cartesian waypoints
+ *
+ * The storage is allocated once in the constructor. Adding and removing
+ * waypoints, copying between buffers of the same capacity, and sampling
+ * never allocate, so that buffers can be handed to the control loop with a
+ * realtime_tools::RealtimeBuffer and sampled there.
+ */
+class TrajectoryBuffer
+{
+  public:
+    struct Waypoint
+    {
+      ros::Time   stamp;
+      KDL::Frame  frame;
+    };
+
+    enum Interpolation
+    {
+      LINEAR,   ///< Linear in position, SLERP in orientation
+      CUBIC     ///< Cubic Hermite splines in position, SLERP in orientation
+    };
+
+    explicit TrajectoryBuffer(std::size_t capacity = 0);
+
+    std::size_t size() const { return m_size; }
+
+    std::size_t capacity() const { return m_waypoints.size(); }
+
+    //! Access with index 0 as the oldest waypoint
+    const Waypoint& operator[](std::size_t index) const;
+
+    void clear();
+
+    /**
+     * @brief Add a waypoint to the end
+     *
+     * @return False if the buffer is full or the stamp is not after the last waypoint's stamp
+     */
+    bool push_back(const Waypoint& waypoint);
+
+    /**
+     * @brief Remove waypoints that lie in the past
+     *
+     * The last two waypoints before the given time are kept for the
+     * interpolation of the current segment.
+     */
+    void dropBefore(const ros::Time& time);
+
+    //! Remove all waypoints at or after the given time
+    void dropFrom(const ros::Time& time);
+
+    /**
+     * @brief Sample the trajectory at the given time
+     *
+     * Before the first waypoint, this interpolates linearly from the given
+     * start. After the last waypoint, this returns the last waypoint.
+     *
+     * @param time The time to sample
+     * @param start Start pose of the motion towards the first waypoint
+     * @param interpolation The interpolation scheme between waypoints
+     * @param cursor Index of the last segment's start. Speeds up
+     * monotonically increasing sample times. Reset it to zero for a new
+     * trajectory.
+     *
+     * @return The interpolated pose
+     */
+    KDL::Frame sample(
+        const ros::Time& time,
+        const Waypoint& start,
+        Interpolation interpolation,
+        std::size_t& cursor) const;
+
+  private:
+    //! Linear interpolation in position and SLERP in orientation
+    static KDL::Frame interpolate(const Waypoint& a, const Waypoint& b, const ros::Time& time);
+
+    //! Velocity estimate at the given waypoint for cubic interpolation
+    KDL::Vector tangent(std::size_t index) const;
+
+    std::vector<Waypoint>   m_waypoints;
+    std::size_t             m_begin;
+    std::size_t             m_size;
+};
+
+}
+
+#endif
@@ -42,6 +42,11 @@
 
 // Project
 #include <cartesian_controller_base/cartesian_controller_base.h>
+#include <cartesian_controller_base/PoseMailbox.h>
+#include <cartesian_controller_base/CompactStream.h>
+#include <cartesian_controller_base/CompactPose.h>
+#include <cartesian_controller_base/CompactPoseBatch.h>
+#include <cartesian_motion_controller/TrajectoryBuffer.h>
 
 // ROS
 #include <kdl/frames.hpp>
@@ -49,6 +54,14 @@
 #include <tf/LinearMath/Quaternion.h>
 #include "tf/transform_datatypes.h"
 #include <geometry_msgs/PoseStamped.h>
+#include <nav_msgs/Path.h>
+
+// ros_control
+#include <realtime_tools/realtime_buffer.h>
+#include <realtime_tools/realtime_publisher.h>
+
+// Other
+#include <boost/thread/mutex.hpp>
 
 namespace cartesian_motion_controller
 {
@@ -75,7 +88,21 @@ namespace cartesian_motion_controller
  * qualitatively high P gains. Note, however, that this requires
  * high-frequently published targets to avoid jumps on joint level.
  *
- * @tparam HardwareInterface The interface to support. Either PositionJointInterface or VelocityJointInterface
+ * Producers of target poses in the same process, such as the
+ * joint_to_cartesian_controller, hand their targets over directly through a
+ * \ref cartesian_controller_base::PoseMailbox instead of the topic.
+ *
+ * Alternatively, users can stream batches of timestamped waypoints as \a
+ * nav_msgs::Path messages. The controller buffers these and interpolates
+ * the target pose in each control cycle, so that the waypoints can be sent
+ * at a much lower rate than the controller runs.
+ *
+ * For constrained links, both also come as compact messages on the \a
+ * compact/target_frame and \a compact/target_frame_batch topics, see
+ * \ref cartesian_controller_base::CompactStream.
+ *
+ * @tparam HardwareInterface The interface to support. One of those of
+ * cartesian_controller_base::CartesianControllerBase
  */
 template <class HardwareInterface>
 class CartesianMotionController : public virtual cartesian_controller_base::CartesianControllerBase<HardwareInterface>
@@ -101,26 +128,139 @@ class CartesianMotionController : public virtual cartesian_controller_base::Cart
      * component, using Rodrigues vector notation.
      *
      * The robot's current pose is computed with forward kinematics, using either
-     * virtually simulated joint positions (for PositionJointInterface), or
-     * real joint positions (for VelocityJointInterface).
+     * virtually simulated joint positions (for PositionJointInterface and the
+     * PosVel interfaces), or real joint positions (for VelocityJointInterface
+     * and EffortJointInterface).
      *
      * @return The error as a 6-dim vector (linear, angular) w.r.t to the robot base link
      */
     ctrl::Vector6D        computeMotionError();
 
+    /**
+     * @brief Apply the latest target from the subscriber callbacks
+     *
+     * Call this once at the beginning of each control cycle. All solver
+     * iterations of that cycle then work on the same consistent target.
+     * If a trajectory is active, this samples it at the given time.
+     *
+     * @param time The current time of the control cycle
+     */
+    void updateTargetFrame(const ros::Time& time);
+
+    /**
+     * @brief Publish the current end effector pose
+     *
+     * Publishing never blocks the control loop and is limited to the rate
+     * given by the \a publish_rate/current_pose parameter. A rate of zero
+     * disables publishing. Call this once per control cycle.
+     *
+     * @param time The current time of the control cycle
+     */
+    void publishCurrentPose(const ros::Time& time);
+
   private:
+    /**
+     * @brief Targets handed over from the subscriber callbacks
+     *
+     * The frame is either an absolute target pose or an offset to the end
+     * effector pose at the time the control loop reads it. A changed sequence
+     * number signals a new target.
+     */
+    struct TargetInput
+    {
+      TargetInput()
+        : relative(false), seq(0)
+      {};
+
+      KDL::Frame    frame;
+      bool          relative;
+      unsigned int  seq;
+    };
+
     void targetFrameCallback(const geometry_msgs::PoseStamped& pose);
 
+    void compactTargetFrameCallback(const cartesian_controller_base::CompactPose& pose);
+
+    /**
+     * @brief Hand a target over to the control loop
+     *
+     * @param frame The target pose or offset, see \ref TargetInput
+     * @param relative Whether the frame is an offset
+     */
+    void writeTargetInput(const KDL::Frame& frame, bool relative);
+
     void targetTwistCallback(const geometry_msgs::Twist &target);
 
+    /**
+     * @brief Waypoints handed over from the trajectory callback
+     *
+     * The buffer contains all waypoints that are still relevant. A changed
+     * sequence number signals a new version.
+     */
+    struct TrajectoryInput
+    {
+      explicit TrajectoryInput(std::size_t capacity = 0)
+        : waypoints(capacity), seq(0)
+      {};
+
+      TrajectoryBuffer  waypoints;
+      unsigned int      seq;
+    };
+
+    /**
+     * @brief Merge a batch of waypoints into the buffered trajectory
+     *
+     * Buffered waypoints at or after the batch's first stamp are replaced.
+     * An empty batch clears the trajectory and stops at the current target.
+     */
+    void targetTrajectoryCallback(const nav_msgs::Path& path);
+
+    void compactTargetTrajectoryCallback(const cartesian_controller_base::CompactPoseBatch& batch);
+
+    /**
+     * @brief Merge the waypoints of \a m_trajectory_batch into the buffered trajectory
+     *
+     * Call this with \a m_target_input_mutex locked.
+     */
+    void mergeTrajectoryBatch();
+
   ros::Subscriber m_target_frame_subscr;
   ros::Subscriber m_target_twist_subscr;
-  ros::Publisher  current_frame_pub;
   std::string     m_target_frame_topic;
   std::string     m_target_twist_topic;
   KDL::Frame      m_target_frame;
   KDL::Frame      m_current_frame;
-  geometry_msgs::PoseStamped current_pose;
+
+  realtime_tools::RealtimeBuffer<TargetInput> m_target_input;
+  boost::mutex    m_target_input_mutex;  ///< Serializes the subscriber callbacks
+  unsigned int    m_target_input_seq;    ///< Last sequence number sent by the callbacks
+  unsigned int    m_target_seq;          ///< Last sequence number applied in the control loop
+
+  // Compact targets
+  ros::Subscriber m_compact_target_frame_subscr;
+  ros::Subscriber m_compact_target_trajectory_subscr;
+  cartesian_controller_base::CompactStream m_compact_target_frame_stream;
+  cartesian_controller_base::CompactStream m_compact_target_trajectory_stream;
+
+  // Targets of producers in the same process
+  cartesian_controller_base::PoseMailbox::Ptr m_target_mailbox;
+  unsigned long   m_target_mailbox_seq;  ///< Last sequence number read from the mailbox
+
+  // Trajectory streaming
+  ros::Subscriber                               m_target_trajectory_subscr;
+  realtime_tools::RealtimeBuffer<TrajectoryInput> m_trajectory_input;
+  TrajectoryInput                               m_trajectory_update;   ///< Merged in the callback
+  std::vector<TrajectoryBuffer::Waypoint>       m_trajectory_batch;    ///< Waypoints of the last message
+  TrajectoryBuffer::Interpolation               m_trajectory_interpolation;
+  TrajectoryBuffer::Waypoint                    m_trajectory_start;
+  std::size_t                                   m_trajectory_cursor;
+  unsigned int                                  m_trajectory_seq;      ///< Last version applied in the control loop
+  bool                                          m_trajectory_active;
+
+  typedef realtime_tools::RealtimePublisher<geometry_msgs::PoseStamped> PosePublisher;
+  boost::shared_ptr<PosePublisher> m_current_pose_publisher;
+  double          m_current_pose_publish_rate;
+  ros::Time       m_last_current_pose_publish_time;
 };
 
 }
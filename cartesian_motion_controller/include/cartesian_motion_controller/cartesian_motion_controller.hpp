@@ -44,6 +44,7 @@
 #include <cartesian_motion_controller/cartesian_motion_controller.h>
 
 // Other
+#include <algorithm>
 #include <boost/algorithm/clamp.hpp>
 
 namespace cartesian_motion_controller
@@ -53,6 +54,13 @@ template <class HardwareInterface>
 CartesianMotionController<HardwareInterface>::
 CartesianMotionController()
 : Base::CartesianControllerBase()
+, m_target_input_seq(0)
+, m_target_seq(0)
+, m_target_mailbox_seq(0)
+, m_trajectory_interpolation(TrajectoryBuffer::LINEAR)
+, m_trajectory_cursor(0)
+, m_trajectory_seq(0)
+, m_trajectory_active(false)
 {
 }
 
@@ -77,13 +85,62 @@ init(HardwareInterface* hw, ros::NodeHandle& nh)
       &CartesianMotionController<HardwareInterface>::targetFrameCallback,
       this);
 
+  m_target_mailbox = cartesian_controller_base::PoseMailbox::get(
+      nh.resolveName(m_target_frame_topic),Base::m_robot_base_link);
+
   m_target_twist_subscr = nh.subscribe(
       "/spacenav/twist",
       3,
       &CartesianMotionController<HardwareInterface>::targetTwistCallback,
       this);
 
-  current_frame_pub = nh.advertise<geometry_msgs::PoseStamped>("current_pose", 5);
+  // Trajectory streaming into preallocated buffers
+  std::string target_trajectory_topic;
+  std::string interpolation;
+  int capacity;
+  nh.param<std::string>("target_trajectory_topic",target_trajectory_topic,"target_trajectory");
+  nh.param<std::string>("trajectory/interpolation",interpolation,"linear");
+  nh.param("trajectory/capacity",capacity,1000);
+  if (interpolation == "cubic")
+  {
+    m_trajectory_interpolation = TrajectoryBuffer::CUBIC;
+  }
+  else if (interpolation != "linear")
+  {
+    ROS_WARN_STREAM("Unknown " << nh.getNamespace() + "/trajectory/interpolation"
+        << " '" << interpolation << "'. Will default to: linear");
+  }
+  m_trajectory_update = TrajectoryInput(std::max(capacity,2));
+  m_trajectory_input.initRT(m_trajectory_update);
+
+  m_target_trajectory_subscr = nh.subscribe(
+      target_trajectory_topic,
+      3,
+      &CartesianMotionController<HardwareInterface>::targetTrajectoryCallback,
+      this);
+
+  // Compact variants of both for constrained links
+  if (!m_compact_target_frame_stream.init(nh,"compact/target_frame",Base::m_robot_base_link) ||
+      !m_compact_target_trajectory_stream.init(nh,"compact/target_frame_batch",Base::m_robot_base_link))
+  {
+    return false;
+  }
+  m_compact_target_frame_subscr = nh.subscribe(
+      "compact/target_frame",
+      3,
+      &CartesianMotionController<HardwareInterface>::compactTargetFrameCallback,
+      this);
+  m_compact_target_trajectory_subscr = nh.subscribe(
+      "compact/target_frame_batch",
+      3,
+      &CartesianMotionController<HardwareInterface>::compactTargetTrajectoryCallback,
+      this);
+
+  nh.param("publish_rate/current_pose",m_current_pose_publish_rate,100.0);
+  m_current_pose_publisher.reset(new PosePublisher(nh,"current_pose",3));
+  m_current_pose_publisher->lock();
+  m_current_pose_publisher->msg_.header.frame_id = Base::m_robot_base_link;
+  m_current_pose_publisher->unlock();
 
   return true;
 }
@@ -94,10 +151,16 @@ starting(const ros::Time& time)
 {
   // Reset simulation with real joint state
   Base::starting(time);
-  m_current_frame = Base::m_forward_dynamics_solver.getEndEffectorPose();
+  m_current_frame = Base::m_ik_solver->getEndEffectorPose();
 
-  // Start where we are
+  // Start where we are and ignore targets from before
   m_target_frame = m_current_frame;
+  m_target_seq = m_target_input.readFromRT()->seq;
+  m_target_mailbox_seq = m_target_mailbox->sequence();
+  m_trajectory_seq = m_trajectory_input.readFromRT()->seq;
+  m_trajectory_active = false;
+
+  m_last_current_pose_publish_time = time;
 }
 
 template <class HardwareInterface>
@@ -114,35 +177,79 @@ update(const ros::Time& time, const ros::Duration& period)
   // control process. So, we control the internal model until we meet the
   // Cartesian target motion. This internal control needs some simulation time
   // steps.
-  for (int i = 0; i < Base::m_iterations; ++i)
+  updateTargetFrame(time);
+  Base::startIterations(period);
+  for (int i = 0; i < Base::m_settings.iterations; ++i)
   {
     // The internal 'simulation time' is deliberately independent of the outer
     // control cycle.
-    ros::Duration internal_period(0.02);
+    ros::Duration internal_period = Base::m_settings.internal_period;
 
     // Compute the motion error = target - current.
     ctrl::Vector6D error = computeMotionError();
 
+    // Stop early in adaptive mode
+    if (!Base::continueIterations(error))
+    {
+      break;
+    }
+
     // Turn Cartesian error into joint motion
     Base::computeJointControlCmds(error,internal_period);
   }
+  Base::finishIterations();
 
   // Write final commands to the hardware interface
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  publishCurrentPose(time);
 }
 
 template <>
 void CartesianMotionController<hardware_interface::VelocityJointInterface>::
 update(const ros::Time& time, const ros::Duration& period)
 {
-  // Simulate only one step forward to avoid drift.
-  ros::Duration internal_period(0.02);
+  updateTargetFrame(time);
 
+  Base::startIterations(period);
+
+  // Simulate only one step forward to avoid drift.
+  ros::Duration internal_period = Base::m_settings.internal_period;
   ctrl::Vector6D error = computeMotionError();
 
   Base::computeJointControlCmds(error,internal_period);
+  Base::finishIterations();
 
   Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  publishCurrentPose(time);
+}
+
+template <>
+void CartesianMotionController<hardware_interface::EffortJointInterface>::
+update(const ros::Time& time, const ros::Duration& period)
+{
+  // Start with the robot state of this cycle
+  Base::startIterations(period);
+
+  updateTargetFrame(time);
+
+  // One step on the real robot state without simulation.
+  // The PD controller's output is the end effector wrench.
+  ctrl::Vector6D error = computeMotionError();
+
+  Base::computeJointControlCmds(error,period);
+  Base::finishIterations();
+
+  Base::writeJointControlCmds();
+
+  // Telemetry
+  Base::publishJointControlCmds(time);
+  publishCurrentPose(time);
 }
 
 template <class HardwareInterface>
@@ -150,11 +257,8 @@ ctrl::Vector6D CartesianMotionController<HardwareInterface>::
 computeMotionError()
 {
   // Compute motion error wrt robot_base_link
-  m_current_frame = Base::m_forward_dynamics_solver.getEndEffectorPose();
-  current_pose.header.stamp = ros::Time::now();
+  m_current_frame = Base::m_ik_solver->getEndEffectorPose();
 
-  tf::poseKDLToMsg(m_current_frame, current_pose.pose);
-  current_frame_pub.publish(current_pose);
   // Transformation from target -> current corresponds to error = target - current
   KDL::Frame error_kdl;
   error_kdl.M = m_target_frame.M * m_current_frame.M.Inverse();
@@ -189,6 +293,86 @@ computeMotionError()
   return error;
 }
 
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+updateTargetFrame(const ros::Time& time)
+{
+  const TargetInput& input = *m_target_input.readFromRT();
+  if (input.seq != m_target_seq)
+  {
+    m_target_seq = input.seq;
+
+    // Single targets take over from trajectories
+    m_trajectory_active = false;
+
+    if (input.relative)
+    {
+      // Offset w. r. t. the current end effector pose
+      m_current_frame = Base::m_ik_solver->getEndEffectorPose();
+      m_target_frame = KDL::Frame(
+          input.frame.M * m_current_frame.M,
+          m_current_frame.p + input.frame.p);
+    }
+    else
+    {
+      m_target_frame = input.frame;
+    }
+  }
+
+  // Targets from producers in this process
+  ros::Time stamp;
+  if (m_target_mailbox->read(m_target_frame,stamp,m_target_mailbox_seq))
+  {
+    m_trajectory_active = false;
+  }
+
+  const TrajectoryInput& trajectory = *m_trajectory_input.readFromRT();
+  if (trajectory.seq != m_trajectory_seq)
+  {
+    // Move smoothly from the current target to the new waypoints
+    m_trajectory_seq = trajectory.seq;
+    m_trajectory_active = trajectory.waypoints.size() > 0;
+    m_trajectory_start.stamp = time;
+    m_trajectory_start.frame = m_target_frame;
+    m_trajectory_cursor = 0;
+  }
+
+  if (m_trajectory_active)
+  {
+    m_target_frame = trajectory.waypoints.sample(
+        time,
+        m_trajectory_start,
+        m_trajectory_interpolation,
+        m_trajectory_cursor);
+  }
+  Base::recordTarget(m_target_frame);
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+publishCurrentPose(const ros::Time& time)
+{
+  if (m_current_pose_publish_rate <= 0.0 ||
+      m_last_current_pose_publish_time + ros::Duration(1.0 / m_current_pose_publish_rate) > time)
+  {
+    return;
+  }
+
+  // Drop this sample if the publisher thread is still busy
+  if (!m_current_pose_publisher->trylock())
+  {
+    return;
+  }
+  m_last_current_pose_publish_time = time;
+
+  m_current_pose_publisher->msg_.header.stamp = time;
+  tf::poseKDLToMsg(
+      Base::m_ik_solver->getEndEffectorPose(),
+      m_current_pose_publisher->msg_.pose);
+
+  m_current_pose_publisher->unlockAndPublish();
+}
+
 template <class HardwareInterface>
 void CartesianMotionController<HardwareInterface>::
 targetFrameCallback(const geometry_msgs::PoseStamped& target)
@@ -201,54 +385,158 @@ targetFrameCallback(const geometry_msgs::PoseStamped& target)
     return;
   }
 
-  m_target_frame = KDL::Frame(
-      KDL::Rotation::Quaternion(
-        target.pose.orientation.x,
-        target.pose.orientation.y,
-        target.pose.orientation.z,
-        target.pose.orientation.w),
-      KDL::Vector(
-        target.pose.position.x,
-        target.pose.position.y,
-        target.pose.position.z));
+  // The producer is in this process and also writes to the mailbox
+  if (m_target_mailbox->isActive(ros::Time::now(),ros::Duration(1.0)))
+  {
+    return;
+  }
+
+  writeTargetInput(
+      KDL::Frame(
+        KDL::Rotation::Quaternion(
+          target.pose.orientation.x,
+          target.pose.orientation.y,
+          target.pose.orientation.z,
+          target.pose.orientation.w),
+        KDL::Vector(
+          target.pose.position.x,
+          target.pose.position.y,
+          target.pose.position.z)),
+      false);
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+compactTargetFrameCallback(const cartesian_controller_base::CompactPose& target)
+{
+  if (!m_compact_target_frame_stream.accept(target.frame,target.seq))
+  {
+    return;
+  }
+
+  float values[7];
+  std::copy(target.position.begin(),target.position.end(),values);
+  std::copy(target.orientation.begin(),target.orientation.end(),values + 3);
+  writeTargetInput(cartesian_controller_base::CompactStream::toFrame(values),false);
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+writeTargetInput(const KDL::Frame& frame, bool relative)
+{
+  boost::mutex::scoped_lock lock(m_target_input_mutex);
+  TargetInput input;
+  input.frame = frame;
+  input.relative = relative;
+  input.seq = ++m_target_input_seq;
+  m_target_input.writeFromNonRT(input);
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+targetTrajectoryCallback(const nav_msgs::Path& path)
+{
+  if (path.header.frame_id != Base::m_robot_base_link)
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got target trajectory in wrong reference frame. Expected: "
+        << Base::m_robot_base_link << " but got "
+        << path.header.frame_id);
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(m_target_input_mutex);
+  m_trajectory_batch.resize(path.poses.size());
+  for (size_t i = 0; i < path.poses.size(); ++i)
+  {
+    const geometry_msgs::Pose& pose = path.poses[i].pose;
+    m_trajectory_batch[i].stamp = path.poses[i].header.stamp;
+    m_trajectory_batch[i].frame = KDL::Frame(
+        KDL::Rotation::Quaternion(
+          pose.orientation.x,
+          pose.orientation.y,
+          pose.orientation.z,
+          pose.orientation.w),
+        KDL::Vector(
+          pose.position.x,
+          pose.position.y,
+          pose.position.z));
+  }
+  mergeTrajectoryBatch();
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+compactTargetTrajectoryCallback(const cartesian_controller_base::CompactPoseBatch& batch)
+{
+  if (!m_compact_target_trajectory_stream.accept(batch.frame,batch.seq))
+  {
+    return;
+  }
+  if (batch.poses.size() != 7 * batch.stamps.size())
+  {
+    ROS_WARN_STREAM_THROTTLE(3, "Got compact target trajectory with "
+        << batch.poses.size() << " values for " << batch.stamps.size()
+        << " stamps. Expected seven values per stamp.");
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(m_target_input_mutex);
+  m_trajectory_batch.resize(batch.stamps.size());
+  for (size_t i = 0; i < batch.stamps.size(); ++i)
+  {
+    m_trajectory_batch[i].stamp = batch.stamps[i];
+    m_trajectory_batch[i].frame = cartesian_controller_base::CompactStream::toFrame(&batch.poses[7 * i]);
+  }
+  mergeTrajectoryBatch();
+}
+
+template <class HardwareInterface>
+void CartesianMotionController<HardwareInterface>::
+mergeTrajectoryBatch()
+{
+  TrajectoryBuffer& waypoints = m_trajectory_update.waypoints;
+  if (m_trajectory_batch.empty())
+  {
+    waypoints.clear();
+  }
+  else
+  {
+    waypoints.dropFrom(m_trajectory_batch[0].stamp);
+    waypoints.dropBefore(ros::Time::now());
+  }
+
+  for (size_t i = 0; i < m_trajectory_batch.size(); ++i)
+  {
+    if (!waypoints.push_back(m_trajectory_batch[i]))
+    {
+      ROS_WARN_STREAM_THROTTLE(3, "Dropped target trajectory waypoints. "
+          "They must have increasing stamps and fit into the buffer of "
+          << waypoints.capacity() << " waypoints.");
+      break;
+    }
+  }
+
+  m_trajectory_update.seq++;
+  m_trajectory_input.writeFromNonRT(m_trajectory_update);
 }
 
 template <class HardwareInterface>
 void CartesianMotionController<HardwareInterface>::
 targetTwistCallback(const geometry_msgs::Twist& twist)
 {
-  geometry_msgs::Pose target = current_pose.pose;
-  target.position.x += twist.linear.x;
-  target.position.y += twist.linear.y;
-  target.position.z += twist.linear.z;
-
-
-  tf::Quaternion temp1;
-  tf::quaternionMsgToTF(target.orientation, temp1);
-  tf::Quaternion temp2;
-  temp2.setRPY(twist.angular.x, twist.angular.y, twist.angular.z);
-
-  quaternionTFToMsg(temp2*temp1,target.orientation);
-
-
-//  if (target.header.frame_id != Base::m_robot_base_link)
-//  {
-//    ROS_WARN_STREAM_THROTTLE(3, "Got target pose in wrong reference frame. Expected: "
-//        << Base::m_robot_base_link << " but got "
-//        << target.header.frame_id);
-//    return;
-//  }
-
-  m_target_frame = KDL::Frame(
-      KDL::Rotation::Quaternion(
-        target.orientation.x,
-        target.orientation.y,
-        target.orientation.z,
-        target.orientation.w),
-      KDL::Vector(
-        target.position.x,
-        target.position.y,
-        target.position.z));
+  // The control loop applies this offset to the end effector pose when it
+  // reads the input. Translation is added, rotation is pre-multiplied.
+  writeTargetInput(
+      KDL::Frame(
+        KDL::Rotation::RPY(
+          twist.angular.x,
+          twist.angular.y,
+          twist.angular.z),
+        KDL::Vector(
+          twist.linear.x,
+          twist.linear.y,
+          twist.linear.z)),
+      true);
 }
 
 } // namespace
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    TrajectoryBuffer.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_motion_controller/TrajectoryBuffer.h>
+
+// Other
+#include <boost/algorithm/clamp.hpp>
+
+namespace cartesian_motion_controller
+{
+
+TrajectoryBuffer::TrajectoryBuffer(std::size_t capacity)
+  : m_waypoints(capacity)
+  , m_begin(0)
+  , m_size(0)
+{
+}
+
+const TrajectoryBuffer::Waypoint& TrajectoryBuffer::operator[](std::size_t index) const
+{
+  return m_waypoints[(m_begin + index) % m_waypoints.size()];
+}
+
+void TrajectoryBuffer::clear()
+{
+  m_begin = 0;
+  m_size = 0;
+}
+
+bool TrajectoryBuffer::push_back(const Waypoint& waypoint)
+{
+  if (m_size == m_waypoints.size() ||
+      (m_size > 0 && waypoint.stamp <= (*this)[m_size - 1].stamp))
+  {
+    return false;
+  }
+  m_waypoints[(m_begin + m_size) % m_waypoints.size()] = waypoint;
+  ++m_size;
+  return true;
+}
+
+void TrajectoryBuffer::dropBefore(const ros::Time& time)
+{
+  // Keep one more for the cubic tangent at the segment start
+  while (m_size >= 3 && (*this)[2].stamp <= time)
+  {
+    m_begin = (m_begin + 1) % m_waypoints.size();
+    --m_size;
+  }
+}
+
+void TrajectoryBuffer::dropFrom(const ros::Time& time)
+{
+  while (m_size > 0 && (*this)[m_size - 1].stamp >= time)
+  {
+    --m_size;
+  }
+}
+
+KDL::Frame TrajectoryBuffer::sample(
+    const ros::Time& time,
+    const Waypoint& start,
+    Interpolation interpolation,
+    std::size_t& cursor) const
+{
+  if (m_size == 0)
+  {
+    return start.frame;
+  }
+  if (time < (*this)[0].stamp)
+  {
+    return interpolate(start,(*this)[0],time);
+  }
+  if (time >= (*this)[m_size - 1].stamp)
+  {
+    return (*this)[m_size - 1].frame;
+  }
+
+  // Find the segment [cursor, cursor + 1] that contains time
+  if (cursor >= m_size - 1 || time < (*this)[cursor].stamp)
+  {
+    cursor = 0;
+  }
+  while ((*this)[cursor + 1].stamp <= time)
+  {
+    ++cursor;
+  }
+
+  const Waypoint& a = (*this)[cursor];
+  const Waypoint& b = (*this)[cursor + 1];
+  KDL::Frame frame = interpolate(a,b,time);
+
+  if (interpolation == CUBIC)
+  {
+    // Hermite basis functions
+    const double dt = (b.stamp - a.stamp).toSec();
+    const double s = (time - a.stamp).toSec() / dt;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    frame.p =
+      (2 * s3 - 3 * s2 + 1) * a.frame.p +
+      (s3 - 2 * s2 + s) * dt * tangent(cursor) +
+      (-2 * s3 + 3 * s2) * b.frame.p +
+      (s3 - s2) * dt * tangent(cursor + 1);
+  }
+  return frame;
+}
+
+KDL::Frame TrajectoryBuffer::interpolate(const Waypoint& a, const Waypoint& b, const ros::Time& time)
+{
+  const double dt = (b.stamp - a.stamp).toSec();
+  const double s = dt > 0.0 ?
+    boost::algorithm::clamp((time - a.stamp).toSec() / dt,0.0,1.0) : 1.0;
+
+  // Rotate about the fixed axis from a to b
+  KDL::Vector axis;
+  const double angle = (a.frame.M.Inverse() * b.frame.M).GetRotAngle(axis);
+
+  return KDL::Frame(
+      a.frame.M * KDL::Rotation::Rot2(axis,s * angle),
+      a.frame.p + s * (b.frame.p - a.frame.p));
+}
+
+KDL::Vector TrajectoryBuffer::tangent(std::size_t index) const
+{
+  // Zero velocity at both ends, central differences in between
+  if (index == 0 || index + 1 >= m_size)
+  {
+    return KDL::Vector::Zero();
+  }
+  const Waypoint& prev = (*this)[index - 1];
+  const Waypoint& next = (*this)[index + 1];
+  return (next.frame.p - prev.frame.p) / (next.stamp - prev.stamp).toSec();
+}
+
+} // namespace
@@ -61,5 +61,35 @@ namespace velocity_controllers
     hardware_interface::VelocityJointInterface> CartesianMotionController;
 }
 
+namespace pos_vel_controllers
+{
+  /**
+   * @brief Cartesian motion controller that transforms end-effector target motion into commands for a chain of position and velocity interfaces.
+   */
+  typedef cartesian_motion_controller::CartesianMotionController<
+    hardware_interface::PosVelJointInterface> CartesianMotionController;
+}
+
+namespace pos_vel_acc_controllers
+{
+  /**
+   * @brief Cartesian motion controller that transforms end-effector target motion into commands for a chain of position, velocity and acceleration interfaces.
+   */
+  typedef cartesian_motion_controller::CartesianMotionController<
+    hardware_interface::PosVelAccJointInterface> CartesianMotionController;
+}
+
+namespace effort_controllers
+{
+  /**
+   * @brief Cartesian motion controller that transforms end-effector target motion into commands for a chain of effort interfaces.
+   */
+  typedef cartesian_motion_controller::CartesianMotionController<
+    hardware_interface::EffortJointInterface> CartesianMotionController;
+}
+
 PLUGINLIB_EXPORT_CLASS(position_controllers::CartesianMotionController, controller_interface::ControllerBase)
 PLUGINLIB_EXPORT_CLASS(velocity_controllers::CartesianMotionController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_controllers::CartesianMotionController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(pos_vel_acc_controllers::CartesianMotionController, controller_interface::ControllerBase)
+PLUGINLIB_EXPORT_CLASS(effort_controllers::CartesianMotionController, controller_interface::ControllerBase)
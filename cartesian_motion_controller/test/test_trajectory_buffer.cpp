@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright 2019 FZI Research Center for Information Technology
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from this
+// software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+/*!\file    test_trajectory_buffer.cpp
+ *
+ * \author  agent <agent@local>
+ * \date    2026/10/14
+ *
+ */
+//-----------------------------------------------------------------------------
+
+// Project
+#include <cartesian_motion_controller/TrajectoryBuffer.h>
+
+// Other
+#include <gtest/gtest.h>
+#include <cmath>
+
+using cartesian_motion_controller::TrajectoryBuffer;
+
+namespace
+{
+
+TrajectoryBuffer::Waypoint waypoint(double stamp, const KDL::Vector& position,
+                                    const KDL::Rotation& orientation = KDL::Rotation::Identity())
+{
+  TrajectoryBuffer::Waypoint point;
+  point.stamp = ros::Time(stamp);
+  point.frame = KDL::Frame(orientation,position);
+  return point;
+}
+
+//! A trajectory whose position is t^2 along x
+TrajectoryBuffer parabola()
+{
+  TrajectoryBuffer buffer(8);
+  for (int i = 1; i <= 6; ++i)
+  {
+    buffer.push_back(waypoint(i,KDL::Vector(i * i,0.0,0.0)));
+  }
+  return buffer;
+}
+
+} // namespace
+
+TEST(TestTrajectoryBuffer, rejectFullBufferAndOldStamps)
+{
+  TrajectoryBuffer buffer(2);
+  EXPECT_TRUE(buffer.push_back(waypoint(1.0,KDL::Vector::Zero())));
+  EXPECT_FALSE(buffer.push_back(waypoint(1.0,KDL::Vector::Zero())));
+  EXPECT_TRUE(buffer.push_back(waypoint(2.0,KDL::Vector::Zero())));
+  EXPECT_FALSE(buffer.push_back(waypoint(3.0,KDL::Vector::Zero())));
+  EXPECT_EQ(buffer.size(),2u);
+}
+
+TEST(TestTrajectoryBuffer, keepTwoWaypointsBeforeNow)
+{
+  TrajectoryBuffer buffer = parabola();
+  buffer.dropBefore(ros::Time(4.5));
+  ASSERT_EQ(buffer.size(),4u);
+  EXPECT_EQ(buffer[0].stamp,ros::Time(3.0));
+
+  // Wraps around the ring's end
+  EXPECT_TRUE(buffer.push_back(waypoint(7.0,KDL::Vector(49.0,0.0,0.0))));
+  EXPECT_TRUE(buffer.push_back(waypoint(8.0,KDL::Vector(64.0,0.0,0.0))));
+  EXPECT_TRUE(buffer.push_back(waypoint(9.0,KDL::Vector(81.0,0.0,0.0))));
+  ASSERT_EQ(buffer.size(),7u);
+  EXPECT_EQ(buffer[6].frame.p.x(),81.0);
+
+  buffer.dropFrom(ros::Time(8.0));
+  EXPECT_EQ(buffer.size(),5u);
+}
+
+TEST(TestTrajectoryBuffer, passThroughWaypoints)
+{
+  const TrajectoryBuffer buffer = parabola();
+  const TrajectoryBuffer::Waypoint start = waypoint(0.0,KDL::Vector::Zero());
+  for (std::size_t i = 0; i < buffer.size(); ++i)
+  {
+    std::size_t cursor = 0;
+    const KDL::Frame linear = buffer.sample(buffer[i].stamp,start,TrajectoryBuffer::LINEAR,cursor);
+    cursor = 0;
+    const KDL::Frame cubic = buffer.sample(buffer[i].stamp,start,TrajectoryBuffer::CUBIC,cursor);
+    EXPECT_NEAR((linear.p - buffer[i].frame.p).Norm(),0.0,1.0e-12);
+    EXPECT_NEAR((cubic.p - buffer[i].frame.p).Norm(),0.0,1.0e-12);
+  }
+}
+
+TEST(TestTrajectoryBuffer, reproduceParabolaWithHermiteSplines)
+{
+  // Central differences give the exact tangents of a parabola at inner
+  // waypoints. Cubic Hermite splines then reproduce it in between, except
+  // in the first and last segments with their zero end tangents.
+  const TrajectoryBuffer buffer = parabola();
+  const TrajectoryBuffer::Waypoint start = waypoint(0.0,KDL::Vector::Zero());
+  std::size_t cursor = 0;
+  for (double t = 2.0; t <= 5.0; t += 0.05)
+  {
+    const KDL::Frame frame = buffer.sample(ros::Time(t),start,TrajectoryBuffer::CUBIC,cursor);
+    EXPECT_NEAR(frame.p.x(),t * t,1.0e-9) << "at t = " << t;
+    EXPECT_NEAR(frame.p.y(),0.0,1.0e-12);
+  }
+
+  // Linear interpolation cuts the corners
+  cursor = 0;
+  const KDL::Frame linear = buffer.sample(ros::Time(2.5),start,TrajectoryBuffer::LINEAR,cursor);
+  EXPECT_NEAR(linear.p.x(),6.5,1.0e-9);
+}
+
+TEST(TestTrajectoryBuffer, reuseCursorForIncreasingTimes)
+{
+  const TrajectoryBuffer buffer = parabola();
+  const TrajectoryBuffer::Waypoint start = waypoint(0.0,KDL::Vector::Zero());
+  std::size_t cursor = 0;
+  for (double t = 0.5; t <= 6.5; t += 0.1)
+  {
+    std::size_t fresh = 0;
+    const KDL::Frame expected = buffer.sample(ros::Time(t),start,TrajectoryBuffer::CUBIC,fresh);
+    const KDL::Frame frame = buffer.sample(ros::Time(t),start,TrajectoryBuffer::CUBIC,cursor);
+    EXPECT_NEAR((frame.p - expected.p).Norm(),0.0,1.0e-12) << "at t = " << t;
+  }
+
+  // Past the end
+  EXPECT_NEAR(buffer.sample(ros::Time(10.0),start,TrajectoryBuffer::CUBIC,cursor).p.x(),36.0,1.0e-12);
+}
+
+TEST(TestTrajectoryBuffer, slerpOrientations)
+{
+  TrajectoryBuffer buffer(4);
+  buffer.push_back(waypoint(1.0,KDL::Vector::Zero()));
+  buffer.push_back(waypoint(2.0,KDL::Vector::Zero(),KDL::Rotation::RotZ(1.0)));
+
+  // Before the first waypoint, move from the start
+  const TrajectoryBuffer::Waypoint start = waypoint(0.0,KDL::Vector(1.0,0.0,0.0));
+  std::size_t cursor = 0;
+  EXPECT_NEAR(buffer.sample(ros::Time(0.5),start,TrajectoryBuffer::LINEAR,cursor).p.x(),0.5,1.0e-12);
+
+  // Rotate about the fixed axis with constant rate
+  KDL::Vector axis;
+  const KDL::Frame frame = buffer.sample(ros::Time(1.25),start,TrajectoryBuffer::CUBIC,cursor);
+  EXPECT_NEAR(frame.M.GetRotAngle(axis),0.25,1.0e-9);
+  EXPECT_NEAR(axis.z(),1.0,1.0e-9);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
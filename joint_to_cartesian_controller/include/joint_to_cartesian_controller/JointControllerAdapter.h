@@ -59,6 +59,16 @@
 namespace joint_to_cartesian_controller
 {
 
+/**
+ * @brief Joint feedback for the connected controllers
+ */
+struct JointStates
+{
+  KDL::JntArray positions;
+  KDL::JntArray velocities;
+  KDL::JntArray efforts;
+};
+
 /**
  * @brief A controller adapter in form of a ROS-control hardware interface
  */
@@ -71,6 +81,15 @@ class JointControllerAdapter : public hardware_interface::RobotHW
 
     bool init(const std::vector<hardware_interface::JointStateHandle>& handles, ros::NodeHandle& nh);
 
+    /**
+     * @brief Update the joint feedback for the connected controllers
+     *
+     * The adapter keeps its own copy of the joint states, so that the
+     * internal controller manager can run in a different thread than the
+     * hardware.
+     */
+    void read(const JointStates& states);
+
     void write(KDL::JntArray& positions);
 
   private:
@@ -89,6 +108,9 @@ class JointControllerAdapter : public hardware_interface::RobotHW
     std::vector<joint_limits_interface::PositionJointSoftLimitsHandle>  m_limits_handles;
 
     std::vector<double> m_cmd;
+    std::vector<double> m_pos;
+    std::vector<double> m_vel;
+    std::vector<double> m_eff;
 };
 
 } // end namespace
@@ -42,6 +42,8 @@
 
 // Project
 #include <joint_to_cartesian_controller/JointControllerAdapter.h>
+#include <cartesian_controller_base/PoseMailbox.h>
+#include <cartesian_controller_base/SeqLock.h>
 
 // ROS
 #include <geometry_msgs/PoseStamped.h>
@@ -55,6 +57,10 @@
 #include <kdl/chain.hpp>
 #include <kdl/chainfksolverpos_recursive.hpp>
 
+// Other
+#include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+
 namespace joint_to_cartesian_controller
 {
 
@@ -74,12 +80,19 @@ namespace joint_to_cartesian_controller
  *
  * Note, however, that transforming joint motion into Cartesian motion for
  * target following loses explicit control over the joints and collision checking.
+ *
+ * The internal controller manager runs in this controller's update() by
+ * default. With a positive async/rate, it runs in its own thread instead,
+ * and update() only exchanges joint states and the latest target pose with
+ * that thread. This keeps expensive joint controllers out of the real-time
+ * loop of the hardware.
  */
 class JointToCartesianController
   : public controller_interface::Controller<hardware_interface::JointStateInterface>
 {
   public:
     JointToCartesianController();
+    ~JointToCartesianController();
 
     bool init(hardware_interface::JointStateInterface* hw, ros::NodeHandle& nh);
 
@@ -90,14 +103,40 @@ class JointToCartesianController
     void update(const ros::Time& time, const ros::Duration& period);
 
   private:
+    /**
+     * @brief Output of the internal controller manager
+     */
+    struct Command
+    {
+      KDL::JntArray positions;
+      KDL::Frame    frame;
+    };
+
+    /**
+     * @brief Run the connected joint controllers and compute their target pose
+     *
+     * @param states The current joint feedback
+     * @param time The current time
+     * @param period The time since the last call
+     * @param command The resulting joint commands and end-effector pose
+     */
+    void updateInternal(const JointStates& states,
+                        const ros::Time& time,
+                        const ros::Duration& period,
+                        Command& command);
+
+    //! Thread function of the asynchronous controller manager
+    void runInternal();
+
     std::string                m_end_effector_link;
     std::string                m_robot_base_link;
     std::string                m_target_frame_topic;
-    KDL::JntArray              m_positions;
-    KDL::JntArray              m_velocities;
     std::vector<std::string>   m_joint_names;
     ros::Publisher             m_pose_publisher;
 
+    //! Direct channel to Cartesian controllers in this process
+    cartesian_controller_base::PoseMailbox::Ptr m_pose_mailbox;
+
     JointControllerAdapter     m_controller_adapter;
 
     std::vector<
@@ -109,6 +148,24 @@ class JointToCartesianController
     boost::shared_ptr<
       controller_manager::ControllerManager>  m_controller_manager;
 
+    // Asynchronous controller manager
+    boost::shared_ptr<boost::thread>  m_internal_thread;
+    boost::atomic<bool>               m_internal_active;   ///< Whether this controller is running
+    boost::atomic<bool>               m_internal_shutdown;
+    double                            m_internal_rate;     ///< Zero for updates in this controller's update()
+    JointStates                       m_states;
+    Command                           m_command;
+    Command                           m_command_scratch;   ///< For reading from the handover
+
+    cartesian_controller_base::SeqLock<JointStates> m_states_handover;  ///< From update() to the internal thread
+    cartesian_controller_base::SeqLock<Command>     m_command_handover; ///< From the internal thread to update()
+    unsigned long                                   m_command_seq;
+
+    // Only used by the internal thread. Sized before it starts.
+    JointStates                       m_internal_states;
+    JointStates                       m_internal_states_scratch;
+    Command                           m_internal_command;
+
 };
 
 }
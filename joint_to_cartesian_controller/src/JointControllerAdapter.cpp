@@ -61,17 +61,28 @@ bool JointControllerAdapter::init(const std::vector<hardware_interface::JointSta
   }
   m_number_joints = m_joint_names.size();
   m_cmd.resize(m_number_joints);
+  m_pos.resize(m_number_joints);
+  m_vel.resize(m_number_joints);
+  m_eff.resize(m_number_joints);
 
   // Start where you are
   for (size_t i = 0; i < m_number_joints; ++i)
   {
     m_cmd[i] = state_handles[i].getPosition();
+    m_pos[i] = state_handles[i].getPosition();
+    m_vel[i] = state_handles[i].getVelocity();
+    m_eff[i] = state_handles[i].getEffort();
   }
 
-  // Register external state_handles
+  // Register state handles to our copy of the external states
   for (int i = 0; i < m_number_joints; ++i)
   {
-    m_state_interface.registerHandle(state_handles[i]);
+    m_state_interface.registerHandle(
+        hardware_interface::JointStateHandle(
+          m_joint_names[i],
+          &m_pos[i],
+          &m_vel[i],
+          &m_eff[i]));
   }
   registerInterface(&m_state_interface);
 
@@ -122,6 +133,21 @@ JointControllerAdapter::~JointControllerAdapter()
 {
 }
 
+void JointControllerAdapter::read(const JointStates& states)
+{
+  if (states.positions.data.size() != m_pos.size())
+  {
+    throw std::runtime_error("Joint number mismatch!");
+  }
+
+  for (size_t i = 0; i < m_pos.size(); ++i)
+  {
+    m_pos[i] = states.positions(i);
+    m_vel[i] = states.velocities(i);
+    m_eff[i] = states.efforts(i);
+  }
+}
+
 void JointControllerAdapter::write(KDL::JntArray& positions)
 {
   if (positions.data.size() != m_cmd.size())
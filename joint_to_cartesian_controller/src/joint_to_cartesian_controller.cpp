@@ -43,16 +43,14 @@
 // Project
 #include <joint_to_cartesian_controller/joint_to_cartesian_controller.h>
 #include <cartesian_controller_base/Utility.h>
-
-// KDL
-#include <kdl/tree.hpp>
-#include <kdl_parser/kdl_parser.hpp>
-
-// URDF
-#include <urdf/model.h>
+#include <cartesian_controller_base/RobotModelCache.h>
 
 // Other
 #include <map>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <boost/bind.hpp>
 
 namespace cartesian_controllers
 {
@@ -80,15 +78,26 @@ namespace joint_to_cartesian_controller
 {
 
 JointToCartesianController::JointToCartesianController()
+  : m_internal_active(false)
+  , m_internal_shutdown(false)
+  , m_internal_rate(0.0)
+  , m_command_seq(0)
 {
 }
 
+JointToCartesianController::~JointToCartesianController()
+{
+  if (m_internal_thread)
+  {
+    m_internal_shutdown = true;
+    m_internal_thread->join();
+  }
+}
+
 bool JointToCartesianController::init(hardware_interface::JointStateInterface* hw, ros::NodeHandle& nh)
 {
   std::string robot_description;
-  urdf::Model robot_model;
-  KDL::Tree   robot_tree;
-  KDL::Chain  robot_chain;
+  cartesian_controller_base::RobotModelCache::ChainPtr robot_chain;
 
   // Get controller specific configuration
   if (!nh.getParam("/robot_description",robot_description))
@@ -118,21 +127,26 @@ bool JointToCartesianController::init(hardware_interface::JointStateInterface* h
 
   // Publishers
   m_pose_publisher = nh.advertise<geometry_msgs::PoseStamped>(m_target_frame_topic,10);
+  m_pose_mailbox = cartesian_controller_base::PoseMailbox::get(
+      nh.resolveName(m_target_frame_topic),m_robot_base_link);
 
-  // Build a kinematic chain of the robot
-  if (!robot_model.initString(robot_description))
+  // Build a kinematic chain of the robot.
+  // Other controllers on the same robot share the parsed models.
+  if (!cartesian_controller_base::RobotModelCache::getUrdf(robot_description))
   {
     ROS_ERROR("Failed to parse urdf model from 'robot_description'");
     return false;
   }
-  if (!kdl_parser::treeFromUrdfModel(robot_model,robot_tree))
+  if (!cartesian_controller_base::RobotModelCache::getTree(robot_description))
   {
     const std::string error = ""
       "Failed to parse KDL tree from urdf model";
     ROS_ERROR_STREAM(error);
     throw std::runtime_error(error);
   }
-  if (!robot_tree.getChain(m_robot_base_link,m_end_effector_link,robot_chain))
+  robot_chain = cartesian_controller_base::RobotModelCache::getChain(
+      robot_description,m_robot_base_link,m_end_effector_link);
+  if (!robot_chain)
   {
     const std::string error = ""
       "Failed to parse robot chain from urdf model. "
@@ -157,47 +171,104 @@ bool JointToCartesianController::init(hardware_interface::JointStateInterface* h
   }
 
   // Adjust joint buffers
-  m_positions.data = ctrl::VectorND::Zero(m_joint_handles.size());
-  m_velocities.data = ctrl::VectorND::Zero(m_joint_handles.size());
+  m_states.positions.data = ctrl::VectorND::Zero(m_joint_handles.size());
+  m_states.velocities.data = ctrl::VectorND::Zero(m_joint_handles.size());
+  m_states.efforts.data = ctrl::VectorND::Zero(m_joint_handles.size());
+  m_command.positions.data = ctrl::VectorND::Zero(m_joint_handles.size());
 
   // Initialize controller adapter and according manager
   m_controller_adapter.init(m_joint_handles,nh);
   m_controller_manager.reset(new controller_manager::ControllerManager(&m_controller_adapter, nh));
 
   // Initialize forward kinematics solver
-  m_fk_solver.reset(new KDL::ChainFkSolverPos_recursive(robot_chain));
+  m_fk_solver.reset(new KDL::ChainFkSolverPos_recursive(*robot_chain));
+
+  // Start where you are
+  m_controller_adapter.write(m_command.positions);
+  m_fk_solver->JntToCart(m_command.positions,m_command.frame);
+
+  // Optionally run the internal controller manager in its own thread
+  nh.param<double>("async/rate",m_internal_rate,0.0);
+  if (m_internal_rate > 0.0)
+  {
+    int priority = 0;
+    int cpu = -1;
+    nh.param<int>("async/priority",priority,0);
+    nh.param<int>("async/cpu",cpu,-1);
+
+    m_states_handover.init(m_states);
+    m_command_handover.init(m_command);
+    m_command_scratch = m_command;
+    m_command_seq = 0;
+    m_internal_states = m_states;
+    m_internal_states_scratch = m_states;
+    m_internal_command = m_command;
+
+    m_internal_thread.reset(new boost::thread(
+          boost::bind(&JointToCartesianController::runInternal, this)));
+    pthread_t handle = m_internal_thread->native_handle();
+
+    if (cpu >= 0)
+    {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cpu, &cpu_set);
+      if (pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpu_set) != 0)
+      {
+        ROS_WARN_STREAM("Failed to pin the internal controller manager to CPU " << cpu);
+      }
+    }
+    if (priority > 0)
+    {
+      sched_param param;
+      param.sched_priority = priority;
+      if (pthread_setschedparam(handle, SCHED_FIFO, &param) != 0)
+      {
+        ROS_WARN_STREAM("Failed to set realtime priority " << priority
+            << " for the internal controller manager. Check your user's rtprio limits.");
+      }
+    }
+  }
 
   return true;
 }
 
 void JointToCartesianController::starting(const ros::Time& time)
 {
-  // Get current joint positions from hardware
-  for (size_t i = 0; i < m_joint_handles.size(); ++i)
-  {
-    m_positions(i) = m_joint_handles[i].getPosition();
-  }
+  m_internal_active = true;
 }
 
 void JointToCartesianController::stopping(const ros::Time& time)
 {
+  m_internal_active = false;
 }
 
 void JointToCartesianController::update(const ros::Time& time, const ros::Duration& period)
 {
-  // Note: The connected joint-based controller gets the feedback directly from
-  // the joint state handles of this joint_to_cartesian_controller. So,
-  // there's no need for a read() function.
+  // Get current joint states from hardware
+  for (size_t i = 0; i < m_joint_handles.size(); ++i)
+  {
+    m_states.positions(i) = m_joint_handles[i].getPosition();
+    m_states.velocities(i) = m_joint_handles[i].getVelocity();
+    m_states.efforts(i) = m_joint_handles[i].getEffort();
+  }
 
-  // Update connected joint controller
-  m_controller_manager->update(time,period);
+  if (m_internal_thread)
+  {
+    // Exchange states and commands with the internal thread.
+    // Keep the last command if there's no new one.
+    m_states_handover.write(m_states);
+    m_command_handover.read(m_command,m_command_seq,m_command_scratch);
+  }
+  else
+  {
+    updateInternal(m_states,time,period,m_command);
+  }
 
-  // Get commanded positions
-  m_controller_adapter.write(m_positions);
+  const KDL::Frame& frame = m_command.frame;
 
-  // Solve forward kinematics
-  KDL::Frame frame;
-  m_fk_solver->JntToCart(m_positions,frame);
+  // Hand over to Cartesian controllers in this process
+  m_pose_mailbox->write(frame,time);
 
   // Publish end-effector pose
   geometry_msgs::PoseStamped target_pose = geometry_msgs::PoseStamped();
@@ -214,4 +285,68 @@ void JointToCartesianController::update(const ros::Time& time, const ros::Durati
   m_pose_publisher.publish(target_pose);
 }
 
+void JointToCartesianController::updateInternal(
+    const JointStates& states,
+    const ros::Time& time,
+    const ros::Duration& period,
+    Command& command)
+{
+  // Update connected joint controller
+  m_controller_adapter.read(states);
+  m_controller_manager->update(time,period);
+
+  // Get commanded positions
+  m_controller_adapter.write(command.positions);
+
+  // Solve forward kinematics
+  m_fk_solver->JntToCart(command.positions,command.frame);
+}
+
+void JointToCartesianController::runInternal()
+{
+  const long period_ns = static_cast<long>(1e9 / m_internal_rate);
+  const long second_ns = 1000000000l;
+
+  unsigned long states_seq = 0;
+  ros::Time last = ros::Time::now();
+
+  timespec next;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+
+  while (!m_internal_shutdown)
+  {
+    // Sleep until the start of the next cycle
+    next.tv_nsec += period_ns;
+    while (next.tv_nsec >= second_ns)
+    {
+      next.tv_nsec -= second_ns;
+      ++next.tv_sec;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+    // Don't try to catch up after overruns
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((now.tv_sec - next.tv_sec) * second_ns + (now.tv_nsec - next.tv_nsec) > period_ns)
+    {
+      next = now;
+    }
+
+    const ros::Time time = ros::Time::now();
+    const ros::Duration period = time - last;
+    last = time;
+
+    // Like the synchronous version, only run the connected controllers while
+    // this controller is running. Wait for the first feedback after starting.
+    m_states_handover.read(m_internal_states,states_seq,m_internal_states_scratch);
+    if (!m_internal_active || states_seq == 0)
+    {
+      continue;
+    }
+
+    updateInternal(m_internal_states,time,period,m_internal_command);
+    m_command_handover.write(m_internal_command);
+  }
+}
+
 }